@@ -5,6 +5,11 @@
 #include <iostream> // Include the input/output stream library
 using namespace std; // Use the standard namespace
 
+// Probe for trace_examples.cpp; it does nothing unless trace.h is included first
+#ifndef TRACE_SCOPE
+#define TRACE_SCOPE(name) static_assert(true, "")
+#endif
+
 // Define an enum called RGB to represent color values
 enum RGB {
     RED,    // Represents the color Red (internally 0)
@@ -14,6 +19,7 @@ enum RGB {
 
 // Function to convert an RGB enum value to its string name
 string rgbToString(RGB color) {
+    TRACE_SCOPE("rgbToString");
     // Use a switch statement to match the input color
     switch (color) {
         case RED:   // If color is RED
@@ -0,0 +1,517 @@
+/*
+ * C++ Allocation Tracking Examples
+ * ================================
+ *
+ * Copies hide in innocent-looking code: the Car setters in
+ * access_specifier.cpp take string by value, s = s + "world" builds a
+ * temporary, and for (string car : cars) in arr.cpp copies every element.
+ * This file demonstrates an opt-in allocation tracker that finds them:
+ * - Replaces the global operator new/delete to count allocations, frees
+ *   and bytes, and to follow live and peak heap memory
+ * - AllocRegion: a scoped label; allocations are charged to the innermost
+ *   region of the thread that makes them
+ * - Sampled call stacks: about one allocation per SAMPLE_BYTES allocated
+ *   bytes records its stack, so the report can show where memory goes
+ * - An end-of-process report and an overhead benchmark
+ *
+ * Concept: Tracking every allocation exactly is too slow to keep on in
+ * production. Here the common path only touches per-thread counters (no
+ * locks, no shared cache lines); the shared live-bytes total is updated
+ * in batches, and the expensive part (capturing a stack) is sampled.
+ * Tracking is off unless ALLOC_TRACK is set in the environment or the
+ * program calls setAllocTracking(true); when off, new costs one branch
+ * more than malloc.
+ *
+ * Build note: link with -rdynamic so stack frames get function names.
+ *
+ * Usage: ./alloctrack [iterations]   (default: 200000)
+ */
+
+#include <algorithm>   // For partial_sort
+#include <atomic>      // For counters shared with the report
+#include <chrono>      // For timing the benchmark
+#include <cstdint>     // For uint64_t
+#include <cstdlib>     // For malloc/free/getenv/strtoul
+#include <cstring>     // For strcmp
+#include <cxxabi.h>    // For demangling function names
+#include <execinfo.h>  // For backtrace()
+#include <iostream>    // For input/output operations
+#include <mutex>       // For the region and stack tables
+#include <new>         // For replacing operator new/delete
+#include <string>      // For string class
+#include <vector>      // For the workload
+using namespace std;
+
+const size_t MAX_REGIONS = 32;        // Region 0 is "(no region)"
+const size_t MAX_STACKS = 256;        // Distinct sampled stacks kept
+const int STACK_DEPTH = 16;
+const long SAMPLE_BYTES = 256 * 1024; // Average bytes between two samples
+const long PUBLISH_BYTES = 64 * 1024; // Per-thread live bytes kept before publishing
+const uint32_t UNTRACKED = 0xFFFFFFFF;  // Region of blocks allocated with tracking off
+
+// Written in front of every block, so delete knows size and region.
+// 16 bytes keeps the user pointer aligned for any fundamental type.
+struct BlockHeader {
+    uint64_t size;
+    uint32_t region;
+    uint32_t offset;  // Distance from the malloc'ed start to the user pointer
+};
+
+/*
+ * Struct: ThreadStats
+ * Purpose: One thread's counters, written only by that thread
+ * The counters are atomics so the report may read them from another
+ * thread, but the owner updates them with a plain load and store (no
+ * locked instruction). Blocks are never freed, so the numbers of threads
+ * that have exited still show up in the report.
+ */
+struct ThreadStats {
+    atomic<uint64_t> allocs[MAX_REGIONS];
+    atomic<uint64_t> frees[MAX_REGIONS];
+    atomic<uint64_t> bytes[MAX_REGIONS];
+    atomic<long> pendingLive;  // Live bytes not yet added to liveBytes
+    long untilSample;
+    uint64_t random;
+    ThreadStats* nextThread;
+};
+
+struct StackSample {
+    void* frames[STACK_DEPTH];
+    int depth;
+    uint64_t hash;
+    uint64_t samples;
+};
+
+// Read by every allocating thread, so atomic; relaxed loads cost nothing extra
+atomic<bool> trackingEnabled(getenv("ALLOC_TRACK") != nullptr);
+
+atomic<ThreadStats*> allThreads(nullptr);
+thread_local ThreadStats* myStats = nullptr;
+thread_local uint32_t currentRegion = 0;
+thread_local bool insideTracker = false;  // Stops the tracker tracking itself
+
+atomic<long> liveBytes(0);
+atomic<long> peakBytes(0);
+
+const char* regionNames[MAX_REGIONS] = {"(no region)"};
+atomic<uint32_t> regionCount(1);
+mutex regionMutex;
+
+StackSample stacks[MAX_STACKS];
+mutex stackMutex;
+
+void setAllocTracking(bool on) {
+    trackingEnabled.store(on, memory_order_relaxed);
+}
+
+void bump(atomic<uint64_t>& counter, uint64_t amount) {
+    counter.store(counter.load(memory_order_relaxed) + amount, memory_order_relaxed);
+}
+
+ThreadStats& threadStats() {
+    if (myStats == nullptr) {
+        // calloc, not new: we are inside operator new
+        ThreadStats* stats = (ThreadStats*)calloc(1, sizeof(ThreadStats));
+        stats->untilSample = SAMPLE_BYTES;
+        stats->random = (uintptr_t)stats | 1;
+        stats->nextThread = allThreads.load();
+        while (!allThreads.compare_exchange_weak(stats->nextThread, stats)) {
+        }
+        myStats = stats;
+    }
+    return *myStats;
+}
+
+/*
+ * Function: recordSample
+ * Purpose: Captures the current call stack and adds it to the table
+ * Called about once per SAMPLE_BYTES allocated bytes. The gap to the
+ * next sample is random (0.5x to 1.5x) so regular allocation patterns
+ * cannot hide between samples.
+ */
+__attribute__((noinline)) void recordSample(ThreadStats& stats) {
+    stats.random ^= stats.random << 13;
+    stats.random ^= stats.random >> 7;
+    stats.random ^= stats.random << 17;
+    stats.untilSample = SAMPLE_BYTES / 2 + (long)(stats.random % SAMPLE_BYTES);
+
+    StackSample sample;
+    sample.depth = backtrace(sample.frames, STACK_DEPTH);
+    sample.hash = 14695981039346656037ull;
+    for (int i = 0; i < sample.depth; i++) {
+        sample.hash = (sample.hash ^ (uintptr_t)sample.frames[i]) * 1099511628211ull;
+    }
+
+    lock_guard<mutex> lock(stackMutex);
+    for (size_t i = 0; i < MAX_STACKS; i++) {
+        StackSample& slot = stacks[(sample.hash + i) % MAX_STACKS];
+        if (slot.samples == 0) {
+            slot = sample;
+            slot.samples = 1;
+            return;
+        }
+        if (slot.hash == sample.hash) {
+            slot.samples++;
+            return;
+        }
+    }
+    // Table full: drop the sample
+}
+
+void publishLive(ThreadStats& stats) {
+    long pending = stats.pendingLive.exchange(0, memory_order_relaxed);
+    long live = liveBytes.fetch_add(pending, memory_order_relaxed) + pending;
+    long peak = peakBytes.load(memory_order_relaxed);
+    while (live > peak && !peakBytes.compare_exchange_weak(peak, live, memory_order_relaxed)) {
+    }
+}
+
+void trackAllocation(BlockHeader* header, size_t size) {
+    header->size = size;
+    header->region = UNTRACKED;
+    if (!trackingEnabled.load(memory_order_relaxed) || insideTracker) {
+        return;
+    }
+    insideTracker = true;
+    ThreadStats& stats = threadStats();
+    uint32_t region = currentRegion;
+    header->region = region;
+    bump(stats.allocs[region], 1);
+    bump(stats.bytes[region], size);
+    long pending = stats.pendingLive.load(memory_order_relaxed) + (long)size;
+    stats.pendingLive.store(pending, memory_order_relaxed);
+    if (pending >= PUBLISH_BYTES) {
+        publishLive(stats);
+    }
+    stats.untilSample -= (long)size;
+    if (stats.untilSample <= 0) {
+        recordSample(stats);
+    }
+    insideTracker = false;
+}
+
+// Decided by the block's tag, not the current setting: a block tracked
+// when allocated is subtracted again even if tracking was turned off since
+void trackFree(BlockHeader* header) {
+    if (insideTracker || header->region == UNTRACKED) {
+        return;
+    }
+    insideTracker = true;
+    ThreadStats& stats = threadStats();
+    bump(stats.frees[header->region], 1);
+    long pending = stats.pendingLive.load(memory_order_relaxed) - (long)header->size;
+    stats.pendingLive.store(pending, memory_order_relaxed);
+    if (pending <= -PUBLISH_BYTES) {
+        publishLive(stats);
+    }
+    insideTracker = false;
+}
+
+void* allocateTracked(size_t size, size_t alignment) {
+    size_t offset = alignment > sizeof(BlockHeader) ? alignment : sizeof(BlockHeader);
+    char* base = (char*)(alignment > sizeof(BlockHeader)
+                         ? aligned_alloc(alignment, (offset + size + alignment - 1) / alignment * alignment)
+                         : malloc(offset + size));
+    if (base == nullptr) {
+        throw bad_alloc();
+    }
+    BlockHeader* header = (BlockHeader*)(base + offset) - 1;
+    header->offset = (uint32_t)offset;
+    trackAllocation(header, size);
+    return base + offset;
+}
+
+void freeTracked(void* p) {
+    if (p == nullptr) {
+        return;
+    }
+    BlockHeader* header = (BlockHeader*)p - 1;
+    trackFree(header);
+    free((char*)p - header->offset);
+}
+
+void* operator new(size_t size) { return allocateTracked(size, 0); }
+void* operator new[](size_t size) { return allocateTracked(size, 0); }
+void* operator new(size_t size, align_val_t align) { return allocateTracked(size, (size_t)align); }
+void* operator new[](size_t size, align_val_t align) { return allocateTracked(size, (size_t)align); }
+void operator delete(void* p) noexcept { freeTracked(p); }
+void operator delete[](void* p) noexcept { freeTracked(p); }
+void operator delete(void* p, size_t) noexcept { freeTracked(p); }
+void operator delete[](void* p, size_t) noexcept { freeTracked(p); }
+void operator delete(void* p, align_val_t) noexcept { freeTracked(p); }
+void operator delete[](void* p, align_val_t) noexcept { freeTracked(p); }
+void operator delete(void* p, size_t, align_val_t) noexcept { freeTracked(p); }
+void operator delete[](void* p, size_t, align_val_t) noexcept { freeTracked(p); }
+
+uint32_t regionId(const char* name) {
+    // Fast path without the lock: names are only ever appended
+    uint32_t count = regionCount.load(memory_order_acquire);
+    for (uint32_t i = 0; i < count; i++) {
+        if (regionNames[i] == name || strcmp(regionNames[i], name) == 0) {
+            return i;
+        }
+    }
+    lock_guard<mutex> lock(regionMutex);
+    count = regionCount.load(memory_order_relaxed);
+    for (uint32_t i = 0; i < count; i++) {
+        if (strcmp(regionNames[i], name) == 0) {
+            return i;
+        }
+    }
+    if (count == MAX_REGIONS) {
+        return 0;  // Table full: charge to "(no region)"
+    }
+    regionNames[count] = name;
+    regionCount.store(count + 1, memory_order_release);
+    return count;
+}
+
+/*
+ * Class: AllocRegion
+ * Purpose: Charges allocations made by this thread inside a scope to a
+ * named region. Regions nest; the innermost one wins. 'name' must stay
+ * alive for the whole program (a string literal).
+ */
+class AllocRegion {
+    private:
+        uint32_t saved;
+
+    public:
+        explicit AllocRegion(const char* name) : saved(currentRegion) {
+            currentRegion = regionId(name);
+        }
+        ~AllocRegion() { currentRegion = saved; }
+
+        AllocRegion(const AllocRegion&) = delete;
+        AllocRegion& operator=(const AllocRegion&) = delete;
+};
+
+// "./alloctrack(_Z9setBrandNSt7...+0x1c) [0x...]" -> "Car::setBrand(...)"
+string frameName(const char* symbol) {
+    const char* open = strchr(symbol, '(');
+    const char* plus = open ? strchr(open, '+') : nullptr;
+    if (open == nullptr || plus == nullptr || plus == open + 1) {
+        return symbol;
+    }
+    string mangled(open + 1, plus);
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(mangled.c_str(), nullptr, nullptr, &status);
+    string name = status == 0 ? demangled : mangled;
+    free(demangled);
+    return name;
+}
+
+// Live heap bytes right now, including every thread's unpublished part
+long liveBytesNow() {
+    long live = liveBytes.load();
+    for (ThreadStats* t = allThreads.load(); t != nullptr; t = t->nextThread) {
+        live += t->pendingLive.load(memory_order_relaxed);
+    }
+    return live;
+}
+
+/*
+ * Function: printAllocReport
+ * Purpose: Prints totals per region, live and peak memory and the most
+ * frequently sampled stacks. Called automatically at exit when tracking
+ * is enabled. Peak memory is exact to within PUBLISH_BYTES per thread.
+ */
+void printAllocReport() {
+    insideTracker = true;
+    uint64_t allocs[MAX_REGIONS] = {}, frees[MAX_REGIONS] = {}, bytes[MAX_REGIONS] = {};
+    for (ThreadStats* t = allThreads.load(); t != nullptr; t = t->nextThread) {
+        for (size_t r = 0; r < MAX_REGIONS; r++) {
+            allocs[r] += t->allocs[r].load(memory_order_relaxed);
+            frees[r] += t->frees[r].load(memory_order_relaxed);
+            bytes[r] += t->bytes[r].load(memory_order_relaxed);
+        }
+    }
+
+    cout << endl << "===== Allocation report =====" << endl;
+    cout << "  region\t\tallocations\tfrees\t\tbytes" << endl;
+    for (uint32_t r = 0; r < regionCount.load(); r++) {
+        if (allocs[r] == 0 && frees[r] == 0) {
+            continue;
+        }
+        cout << "  " << regionNames[r] << (strlen(regionNames[r]) < 14 ? "\t\t" : "\t")
+             << allocs[r] << "\t\t" << frees[r] << "\t\t" << bytes[r] << endl;
+    }
+    long live = liveBytesNow();
+    cout << "  Live at exit: " << live << " bytes, peak about "
+         << max(peakBytes.load(), live) << " bytes" << endl;
+
+    // Top stacks by number of samples
+    lock_guard<mutex> lock(stackMutex);
+    vector<StackSample*> top;
+    for (StackSample& s : stacks) {
+        if (s.samples > 0) top.push_back(&s);
+    }
+    partial_sort(top.begin(), top.begin() + min<size_t>(3, top.size()), top.end(),
+                 [](StackSample* a, StackSample* b) { return a->samples > b->samples; });
+    for (size_t i = 0; i < top.size() && i < 3; i++) {
+        cout << "  Sampled stack #" << i + 1 << ": about " << top[i]->samples * SAMPLE_BYTES / 1024
+             << " KB allocated" << endl;
+        char** symbols = backtrace_symbols(top[i]->frames, top[i]->depth);
+        int shown = 0;
+        for (int f = 0; f < top[i]->depth && shown < 5; f++) {
+            string name = frameName(symbols[f]);
+            if (name.find("recordSample") != string::npos || name.find("track") != string::npos ||
+                name.find("Tracked") != string::npos || name.find("operator new") != string::npos) {
+                continue;  // Frames of the tracker itself
+            }
+            cout << "      " << name.substr(0, 90) << endl;
+            shown++;
+        }
+        free(symbols);
+    }
+    insideTracker = false;
+}
+
+// Prints the report when the program ends (after main returns)
+struct ReportAtExit {
+    ReportAtExit() {
+        void* warmUp[1];
+        backtrace(warmUp, 1);  // First call loads libgcc; do it outside operator new
+    }
+    ~ReportAtExit() {
+        if (trackingEnabled.load(memory_order_relaxed)) {
+            printAllocReport();
+        }
+    }
+} reportAtExit;
+
+// ---------------------------------------------------------------------
+// Workload: the quiet copies from the Car and string examples
+// ---------------------------------------------------------------------
+
+class Car {
+    private:
+        string brand;
+        string model;
+        int year;
+
+    public:
+        Car(string x, string y, int z) {
+            brand = x;
+            model = y;
+            year = z;
+        }
+
+        // Setter Methods, taking string by value as in access_specifier.cpp
+        void setBrand(string x) { brand = x; }
+        void setModel(string y) { model = y; }
+        int getYear() const { return year; }
+};
+
+__attribute__((noinline)) size_t carSetters(size_t iterations) {
+    AllocRegion region("car setters");
+    Car car("Chevrolet Motor Division", "Camaro Convertible Coupe", 2021);
+    string brand = "Ford Motor Company Europe";
+    for (size_t i = 0; i < iterations; i++) {
+        car.setBrand(brand);  // Copies into the parameter, then assigns
+        car.setModel("Mustang Shelby GT500 Coupe");
+    }
+    return car.getYear();
+}
+
+__attribute__((noinline)) size_t concatenation(size_t iterations) {
+    AllocRegion region("concatenation");
+    size_t total = 0;
+    for (size_t i = 0; i < iterations; i++) {
+        string s = "hello, this is a longer greeting ";
+        s = s + "world";  // As in functions.cpp: a temporary, then a copy
+        total += s.size();
+    }
+    return total;
+}
+
+__attribute__((noinline)) size_t rangeForCopies(size_t iterations) {
+    AllocRegion region("range-for copy");
+    string cars[5] = {"Shelby American Incorporated", "Ford Motor Company Europe",
+                      "Bayerische Motoren Werke AG", "Range Rover Land Rover Ltd", "Volvo Car Corporation AB"};
+    size_t total = 0;
+    for (size_t i = 0; i < iterations / 5; i++) {
+        for (string car : cars) {  // Copies every element; const string& would not
+            total += car.size();
+        }
+    }
+    return total;
+}
+
+double nsPerPair(size_t iterations) {
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+        char* p = new char[48];
+        p[0] = (char)i;
+        asm volatile("" : : "r"(p) : "memory");  // Keep the pair from being optimised away
+        delete[] p;
+    }
+    return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / iterations;
+}
+
+double nsPerMallocPair(size_t iterations) {
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+        char* p = (char*)malloc(48);
+        p[0] = (char)i;
+        asm volatile("" : : "r"(p) : "memory");
+        free(p);
+    }
+    return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / iterations;
+}
+
+int main(int argc, char* argv[]) {
+
+    size_t iterations = 200000;
+    if (argc > 1) {
+        iterations = strtoul(argv[1], nullptr, 10);
+    }
+
+    // Overhead first, before the workload fills the tables
+    size_t pairs = iterations * 50;
+    setAllocTracking(false);
+    double plain = nsPerMallocPair(pairs);
+    double off = nsPerPair(pairs);
+    setAllocTracking(true);
+    double on;
+    {
+        AllocRegion region("overhead test");
+        on = nsPerPair(pairs);
+    }
+    cout << "Cost of one new[]/delete[] pair of 48 bytes:" << endl;
+    cout << "  malloc/free:        " << plain << " ns" << endl;
+    cout << "  tracking disabled:  " << off << " ns" << endl;
+    cout << "  tracking enabled:   " << on << " ns" << endl << endl;
+
+    // Tracking stays on for the workload, so this example always reports
+    vector<Car> fleet;
+    {
+        AllocRegion region("car fleet");
+        for (size_t i = 0; i < iterations / 10; i++) {
+            fleet.emplace_back("Chevrolet Motor Division", "Camaro Convertible Coupe", 2021);
+        }
+    }
+    size_t sink = carSetters(iterations) + concatenation(iterations) + rangeForCopies(iterations);
+    cout << "Workload done (" << sink << ")" << endl;
+
+    // A block allocated while tracking is on and freed while it is off
+    // must still leave the live total where it was
+    long liveBefore = liveBytesNow();
+    char* block = new char[1 << 20];
+    setAllocTracking(false);
+    delete[] block;
+    setAllocTracking(true);
+    cout << "Live bytes after new (tracked) + delete (untracked): "
+         << (liveBytesNow() == liveBefore ? "unchanged" : "DRIFTED") << endl;
+
+    /*
+     * Key Learning Points:
+     * 1. Replacing operator new sees every heap allocation in the program
+     * 2. Per-thread counters keep tracking cheap; shared totals are batched
+     * 3. Sampling call stacks finds hot spots at a small fraction of the cost
+     * 4. Scoped regions attribute memory to parts of the program by name
+     * 5. Passing const string& instead of string removes many hidden copies
+     */
+
+    return 0;
+}
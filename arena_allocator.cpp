@@ -0,0 +1,402 @@
+/*
+ * C++ Arena and Pool Allocator Examples
+ * =====================================
+ *
+ * dynamic_allocation.cpp does new string(...) and delete for one object.
+ * A service that handles a request builds thousands of such short-lived
+ * strings and Car objects, and frees all of them when the request is done.
+ * This file demonstrates two allocators for that pattern:
+ * - Arena: a bump-pointer allocator; allocating moves a pointer forward,
+ *   freeing does nothing, and reset() frees everything at once between
+ *   requests while keeping the memory for the next one
+ * - ObjectPool: fixed-size blocks with a free list, for objects that are
+ *   created and deleted one at a time (new/delete style)
+ * - Both are std::pmr::memory_resource, so pmr::string, pmr::vector and
+ *   pmr::unordered_map can use them unchanged
+ * - A request-handling benchmark against the global allocator
+ *
+ * Concept: malloc/new must handle any size, any lifetime and any thread,
+ * so each call does real bookkeeping. When we know more (all objects die
+ * together, or all blocks have one size) a much simpler allocator works.
+ * std::pmr (C++17) lets containers take the allocator as a runtime
+ * pointer, so the same code can run on any of them.
+ *
+ * Usage: ./arena [requests]   (default: 20000)
+ */
+
+#include <algorithm>        // For max
+#include <chrono>           // For timing the benchmark
+#include <cstddef>          // For max_align_t
+#include <cstdint>          // For uintptr_t
+#include <cstdlib>          // For strtoul
+#include <iostream>         // For input/output operations
+#include <memory_resource>  // For pmr::memory_resource (C++17)
+#include <new>              // For placement new
+#include <string>           // For pmr::string
+#include <unordered_map>    // For pmr::unordered_map
+#include <vector>           // For pmr::vector
+using namespace std;
+
+/*
+ * Class: Arena
+ * Purpose: Bump-pointer allocator that frees everything at once
+ * Memory comes from 'upstream' in chunks that double in size. reset()
+ * rewinds to the first chunk but keeps every chunk, so a steady stream of
+ * similar requests stops calling upstream after the first one.
+ * Not thread-safe: use one arena per thread (or per request).
+ */
+class Arena : public pmr::memory_resource {
+    private:
+        struct Chunk {
+            char* data;
+            size_t size;
+        };
+
+        pmr::memory_resource* upstream;
+        vector<Chunk> chunks;
+        size_t current;   // Index of the chunk we are bumping in
+        char* next;       // Next free byte in that chunk
+        char* limit;      // End of that chunk
+        size_t upstreamCalls;
+
+        void useChunk(size_t index) {
+            current = index;
+            next = chunks[index].data;
+            limit = chunks[index].data + chunks[index].size;
+        }
+
+        // Moves to the next chunk that can hold 'bytes', adding one if needed
+        void grow(size_t bytes, size_t alignment) {
+            size_t needed = bytes + alignment;
+            while (current + 1 < chunks.size()) {
+                useChunk(current + 1);
+                if (chunks[current].size >= needed) {
+                    return;
+                }
+            }
+            size_t size = max(chunks.empty() ? needed : chunks.back().size * 2, needed);
+            chunks.push_back({(char*)upstream->allocate(size, alignof(max_align_t)), size});
+            upstreamCalls++;
+            useChunk(chunks.size() - 1);
+        }
+
+    protected:
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            uintptr_t aligned = ((uintptr_t)next + alignment - 1) & ~(uintptr_t)(alignment - 1);
+            if (next == nullptr || aligned + bytes > (uintptr_t)limit) {
+                grow(bytes, alignment);
+                aligned = ((uintptr_t)next + alignment - 1) & ~(uintptr_t)(alignment - 1);
+            }
+            next = (char*)(aligned + bytes);
+            return (void*)aligned;
+        }
+
+        // Individual frees do nothing; memory comes back on reset()
+        void do_deallocate(void*, size_t, size_t) override {}
+
+        bool do_is_equal(const pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+
+    public:
+        explicit Arena(size_t firstChunk = 64 * 1024,
+                       pmr::memory_resource* up = pmr::new_delete_resource())
+            : upstream(up), current(0), next(nullptr), limit(nullptr), upstreamCalls(0) {
+            chunks.push_back({(char*)upstream->allocate(firstChunk, alignof(max_align_t)), firstChunk});
+            upstreamCalls++;
+            useChunk(0);
+        }
+
+        ~Arena() {
+            for (const Chunk& chunk : chunks) {
+                upstream->deallocate(chunk.data, chunk.size, alignof(max_align_t));
+            }
+        }
+
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        // Frees everything allocated so far. Objects in the arena must not
+        // be used afterwards (destroy containers before calling reset()).
+        void reset() { useChunk(0); }
+
+        size_t bytesReserved() const {
+            size_t total = 0;
+            for (const Chunk& chunk : chunks) total += chunk.size;
+            return total;
+        }
+        size_t upstreamAllocations() const { return upstreamCalls; }
+};
+
+/*
+ * Class: ObjectPool
+ * Purpose: Allocator for blocks of one fixed size, with O(1) reuse
+ * Freed blocks go on a singly linked free list stored inside the blocks
+ * themselves. New blocks are cut from slabs of 'blocksPerSlab' blocks.
+ * Requests that are larger or more aligned than a block go to upstream,
+ * so the pool is safe to hand to any pmr container.
+ * Not thread-safe, like Arena.
+ */
+class ObjectPool : public pmr::memory_resource {
+    private:
+        struct FreeBlock {
+            FreeBlock* next;
+        };
+
+        pmr::memory_resource* upstream;
+        size_t blockSize;
+        size_t blocksPerSlab;
+        FreeBlock* freeList;
+        vector<void*> slabs;
+
+        void addSlab() {
+            char* slab = (char*)upstream->allocate(blockSize * blocksPerSlab, alignof(max_align_t));
+            slabs.push_back(slab);
+            // Thread the new blocks onto the free list, lowest address first
+            for (size_t i = blocksPerSlab; i-- > 0;) {
+                FreeBlock* block = (FreeBlock*)(slab + i * blockSize);
+                block->next = freeList;
+                freeList = block;
+            }
+        }
+
+    protected:
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            if (bytes > blockSize || alignment > alignof(max_align_t)) {
+                return upstream->allocate(bytes, alignment);
+            }
+            if (freeList == nullptr) {
+                addSlab();
+            }
+            FreeBlock* block = freeList;
+            freeList = block->next;
+            return block;
+        }
+
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+            if (bytes > blockSize || alignment > alignof(max_align_t)) {
+                upstream->deallocate(p, bytes, alignment);
+                return;
+            }
+            FreeBlock* block = (FreeBlock*)p;
+            block->next = freeList;
+            freeList = block;
+        }
+
+        bool do_is_equal(const pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+
+    public:
+        ObjectPool(size_t size, size_t perSlab = 1024,
+                   pmr::memory_resource* up = pmr::new_delete_resource())
+            : upstream(up), blocksPerSlab(perSlab), freeList(nullptr) {
+            // Round up so every block is aligned for any type
+            size_t align = alignof(max_align_t);
+            blockSize = (max(size, sizeof(FreeBlock)) + align - 1) / align * align;
+        }
+
+        ~ObjectPool() {
+            for (void* slab : slabs) {
+                upstream->deallocate(slab, blockSize * blocksPerSlab, alignof(max_align_t));
+            }
+        }
+
+        ObjectPool(const ObjectPool&) = delete;
+        ObjectPool& operator=(const ObjectPool&) = delete;
+
+        // new T(args...) and delete, but using the pool
+        template <typename T, typename... Args>
+        T* create(Args&&... args) {
+            void* p = allocate(sizeof(T), alignof(T));
+            return new (p) T(std::forward<Args>(args)...);
+        }
+
+        template <typename T>
+        void destroy(T* object) {
+            object->~T();
+            deallocate(object, sizeof(T), alignof(T));
+        }
+
+        size_t slabCount() const { return slabs.size(); }
+};
+
+/*
+ * Class: Car
+ * Purpose: Car from the class examples, with strings that use the
+ * allocator of whatever container (or pool) holds the car
+ * allocator_type tells pmr containers to pass their allocator on to the
+ * cars they construct ("uses-allocator construction").
+ */
+class Car {
+    public:
+        using allocator_type = pmr::polymorphic_allocator<char>;
+
+        pmr::string brand;
+        pmr::string model;
+        int year;
+
+        Car(string_view b, string_view m, int y, allocator_type alloc = {})
+            : brand(b, alloc), model(m, alloc), year(y) {}
+
+        Car(const Car& other, allocator_type alloc)
+            : brand(other.brand, alloc), model(other.model, alloc), year(other.year) {}
+
+        Car(Car&& other, allocator_type alloc)
+            : brand(std::move(other.brand), alloc), model(std::move(other.model), alloc), year(other.year) {}
+};
+
+const char* BRANDS[] = {"Mercedes-Benz Passenger Cars", "Volkswagen Commercial Vehicles",
+                        "Bayerische Motoren Werke", "Ford Motor Company Europe"};
+const char* MODELS[] = {"Grand Touring Coupe Edition", "Long Wheelbase Executive Saloon",
+                        "All Terrain Sport Utility Vehicle"};
+
+/*
+ * Function: handleRequest
+ * Purpose: A typical request: build a list of cars, index them by brand
+ * and produce a text report. Every container and string allocates from
+ * 'memory'; pmr::new_delete_resource() gives the normal global allocator.
+ */
+size_t handleRequest(pmr::memory_resource* memory, int requestId) {
+    pmr::vector<Car> cars(memory);
+    for (int i = 0; i < 200; i++) {
+        cars.emplace_back(BRANDS[(i + requestId) % 4], MODELS[i % 3], 1990 + i % 35);
+    }
+
+    pmr::unordered_map<pmr::string, int> perBrand(memory);
+    for (const Car& car : cars) {
+        perBrand[car.brand]++;
+    }
+
+    pmr::string report(memory);
+    for (const Car& car : cars) {
+        report += car.brand;
+        report += ' ';
+        report += car.model;
+        report += '\n';
+    }
+    return report.size() + perBrand.size();
+}
+
+/*
+ * Function: handlePoolRequest
+ * Purpose: The dynamic_allocation.cpp style: each car is created with
+ * new and later deleted one by one, here with the pool vs global new
+ */
+template <bool USE_POOL>
+size_t handlePoolRequest(ObjectPool& pool, int requestId) {
+    Car* cars[200];
+    size_t total = 0;
+    for (int i = 0; i < 200; i++) {
+        // Short names fit in the strings' inline buffer: only the Car allocates
+        if (USE_POOL) {
+            cars[i] = pool.create<Car>("BMW", "X5", 1990 + (i + requestId) % 35);
+        } else {
+            cars[i] = new Car("BMW", "X5", 1990 + (i + requestId) % 35);
+        }
+    }
+    for (int i = 0; i < 200; i++) {
+        total += cars[i]->year;
+        if (USE_POOL) {
+            pool.destroy(cars[i]);
+        } else {
+            delete cars[i];
+        }
+    }
+    return total;
+}
+
+template <typename Handler>
+double timeRequests(size_t requests, Handler handle) {
+    size_t sink = 0;
+    auto start = chrono::steady_clock::now();
+    for (size_t r = 0; r < requests; r++) {
+        sink += handle((int)r);
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    if (sink == 0) {
+        cout << "(unexpected empty result)" << endl;
+    }
+    return requests / seconds;
+}
+
+void benchmark(size_t requests) {
+    cout << "Handling " << requests << " requests of 200 cars each (requests/s):" << endl;
+
+    double global = timeRequests(requests, [](int id) {
+        return handleRequest(pmr::new_delete_resource(), id);
+    });
+    cout << "  global allocator:          " << global << endl;
+
+    double monotonic = timeRequests(requests, [](int id) {
+        pmr::monotonic_buffer_resource memory;
+        return handleRequest(&memory, id);
+    });
+    cout << "  pmr::monotonic per request: " << monotonic << "  (" << monotonic / global << "x)" << endl;
+
+    Arena arena;
+    double arenaRate = timeRequests(requests, [&arena](int id) {
+        size_t result = handleRequest(&arena, id);
+        arena.reset();
+        return result;
+    });
+    cout << "  Arena with reset():        " << arenaRate << "  (" << arenaRate / global << "x, "
+         << arena.upstreamAllocations() << " upstream allocations, "
+         << arena.bytesReserved() / 1024 << " KB kept)" << endl;
+
+    cout << "Creating and deleting 200 Car objects one by one (requests/s):" << endl;
+    ObjectPool pool(sizeof(Car));
+    double newDelete = timeRequests(requests, [&pool](int id) { return handlePoolRequest<false>(pool, id); });
+    cout << "  new/delete:                " << newDelete << endl;
+    double pooled = timeRequests(requests, [&pool](int id) { return handlePoolRequest<true>(pool, id); });
+    cout << "  ObjectPool:                " << pooled << "  (" << pooled / newDelete << "x, "
+         << pool.slabCount() << " slab)" << endl;
+}
+
+int main(int argc, char* argv[]) {
+
+    // dynamic_allocation.cpp, with the string's memory in an arena
+    Arena arena;
+    pmr::string* dynamicName = new (arena.allocate(sizeof(pmr::string), alignof(pmr::string)))
+        pmr::string("Dynamic Memory Allocation from an Arena", &arena);
+    cout << dynamicName << endl;
+    cout << *dynamicName << endl;
+    dynamicName->~basic_string();  // Destructor still runs; the memory goes back on reset()
+    arena.reset();
+
+    // The same with a pool of Car-sized blocks
+    ObjectPool pool(sizeof(Car));
+    Car* car = pool.create<Car>("Ford", "Mustang", 1969);
+    cout << car->brand << " " << car->model << " " << car->year << " at " << car << endl;
+    pool.destroy(car);
+    Car* reused = pool.create<Car>("BMW", "X5", 1999);
+    cout << "Next car reuses the same block: " << (reused == car ? "yes" : "no") << endl;
+    pool.destroy(reused);
+
+    // Containers pass the arena on to the cars and their strings
+    {
+        pmr::vector<Car> cars(&arena);
+        cars.emplace_back("Volvo Car Corporation of Sweden", "XC90", 2015);
+        cout << "Car string uses the arena: "
+             << (cars[0].brand.get_allocator().resource() == &arena ? "yes" : "no") << endl;
+    }
+    arena.reset();
+    cout << endl;
+
+    size_t requests = 20000;
+    if (argc > 1) {
+        requests = strtoul(argv[1], nullptr, 10);
+    }
+    benchmark(requests);
+
+    /*
+     * Key Learning Points:
+     * 1. new/delete are general-purpose and pay for it on every call
+     * 2. An arena allocates by moving a pointer and frees everything at once
+     * 3. A pool of fixed-size blocks reuses freed memory in O(1)
+     * 4. std::pmr lets strings and containers use any memory_resource
+     * 5. Objects must not outlive the arena or pool they were allocated in
+     */
+
+    return 0;
+}
@@ -0,0 +1,515 @@
+/*
+ * C++ Array Statistics Examples
+ * =============================
+ *
+ * arr.cpp walks its arrays with range-based for loops. For a large int
+ * array the same loops become aggregates (sum, smallest value, number
+ * of distinct values...), and "for (string car : cars)" copies every
+ * string it visits. This file demonstrates a kernel set over contiguous
+ * int32 arrays:
+ * - sumWide(): exact 64-bit sum of 32-bit values
+ * - minMax(): smallest and largest value and where they first occur
+ * - countDistinct() / hasDuplicate(): a bitmap when the values span a
+ *   small range, a flat open-addressing hash set otherwise
+ * - AlignedVector<T>: a vector whose data starts on a 64-byte boundary
+ * - AVX2 versions chosen at startup, a benchmark against the obvious
+ *   loops and standard containers, and a check that iterating strings
+ *   by reference allocates nothing
+ *
+ * Concept: Each kernel is one pass over memory that the CPU can stream
+ * through, 8 ints per AVX2 instruction. The sum widens to 64 bits before
+ * adding, so it cannot overflow below 2^32 elements. Distinct counting
+ * does not need unordered_set: when max - min is small, one bit per
+ * possible value is enough; otherwise a hash table stored in one flat
+ * array avoids the per-element node that unordered_set allocates.
+ *
+ * Usage: ./arrstats [elements]   (default: 2000000)
+ */
+
+#include <algorithm>      // For minmax_element/shuffle
+#include <atomic>         // For the allocation counter
+#include <chrono>         // For timing the benchmark
+#include <cstdint>        // For int32_t/int64_t
+#include <cstdlib>        // For malloc/free/strtoul
+#include <iostream>       // For input/output operations
+#include <new>            // For replacing operator new/delete
+#include <numeric>        // For accumulate/iota
+#include <optional>       // For statistics of empty arrays
+#include <random>         // For test data
+#include <string>         // For the car names
+#include <unordered_set>  // For the hash-set baseline
+#include <vector>         // For storage
+#include <immintrin.h>    // For AVX2 intrinsics
+using namespace std;
+
+// Every heap allocation in this program goes through these functions
+atomic<size_t> allocations(0);
+
+void* operator new(size_t size) {
+    allocations.fetch_add(1, memory_order_relaxed);
+    void* p = malloc(size == 0 ? 1 : size);
+    if (p == nullptr) {
+        throw bad_alloc();
+    }
+    return p;
+}
+
+void* operator new(size_t size, align_val_t align) {
+    allocations.fetch_add(1, memory_order_relaxed);
+    size_t alignment = (size_t)align;
+    void* p = aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    if (p == nullptr) {
+        throw bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, align_val_t) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, size_t, align_val_t) noexcept {
+    free(p);
+}
+
+/*
+ * Struct: AlignedAllocator
+ * Purpose: Allocator for std::vector that aligns the data to 'Align'
+ * bytes (a cache line by default), so no vector load straddles two lines
+ * at the start of the array
+ */
+template <typename T, size_t Align = 64>
+struct AlignedAllocator {
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Align>;
+    };
+
+    AlignedAllocator() = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Align>&) {}
+
+    T* allocate(size_t n) { return (T*)::operator new(n * sizeof(T), align_val_t(Align)); }
+    void deallocate(T* p, size_t) { ::operator delete(p, align_val_t(Align)); }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Align>&) const { return true; }
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Align>&) const { return false; }
+};
+
+template <typename T>
+using AlignedVector = vector<T, AlignedAllocator<T>>;
+
+bool cpuHasAVX2() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+const bool HAS_AVX2 = cpuHasAVX2();
+
+// ---------------------------------------------------------------------
+// Sum
+// ---------------------------------------------------------------------
+
+int64_t sumWideScalar(const int32_t* data, size_t n) {
+    int64_t total = 0;
+    for (size_t i = 0; i < n; i++) total += data[i];
+    return total;
+}
+
+__attribute__((target("avx2")))
+int64_t sumWideAVX2(const int32_t* data, size_t n) {
+    __m256i low = _mm256_setzero_si256(), high = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(data + i));
+        // Sign-extend 4 + 4 values to 64 bits before adding
+        low = _mm256_add_epi64(low, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v)));
+        high = _mm256_add_epi64(high, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1)));
+    }
+    alignas(32) int64_t lanes[4];
+    _mm256_store_si256((__m256i*)lanes, _mm256_add_epi64(low, high));
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + sumWideScalar(data + i, n - i);
+}
+
+/*
+ * Function: sumWide
+ * Purpose: Exact sum of n int32 values (n < 2^32)
+ */
+int64_t sumWide(const int32_t* data, size_t n) {
+    return HAS_AVX2 ? sumWideAVX2(data, n) : sumWideScalar(data, n);
+}
+
+// ---------------------------------------------------------------------
+// Min / max / argmin: one pass for the values, then a search for the
+// first position of each. Both passes compare 8 values per instruction.
+// ---------------------------------------------------------------------
+
+struct MinMax {
+    int32_t min;
+    int32_t max;
+    size_t argmin;  // First index holding min
+    size_t argmax;  // First index holding max
+};
+
+void minMaxValuesScalar(const int32_t* data, size_t n, int32_t& low, int32_t& high) {
+    for (size_t i = 0; i < n; i++) {
+        low = min(low, data[i]);
+        high = max(high, data[i]);
+    }
+}
+
+size_t findFirstScalar(const int32_t* data, size_t n, int32_t value) {
+    size_t i = 0;
+    while (i < n && data[i] != value) i++;
+    return i;
+}
+
+__attribute__((target("avx2")))
+void minMaxValuesAVX2(const int32_t* data, size_t n, int32_t& low, int32_t& high) {
+    __m256i lows = _mm256_set1_epi32(low), highs = _mm256_set1_epi32(high);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(data + i));
+        lows = _mm256_min_epi32(lows, v);
+        highs = _mm256_max_epi32(highs, v);
+    }
+    alignas(32) int32_t lowLanes[8], highLanes[8];
+    _mm256_store_si256((__m256i*)lowLanes, lows);
+    _mm256_store_si256((__m256i*)highLanes, highs);
+    minMaxValuesScalar(lowLanes, 8, low, high);
+    minMaxValuesScalar(highLanes, 8, low, high);
+    minMaxValuesScalar(data + i, n - i, low, high);
+}
+
+__attribute__((target("avx2")))
+size_t findFirstAVX2(const int32_t* data, size_t n, int32_t value) {
+    __m256i wanted = _mm256_set1_epi32(value);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i hits = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)(data + i)), wanted);
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(hits));  // One bit per lane
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return i + findFirstScalar(data + i, n - i, value);
+}
+
+/*
+ * Function: minMax
+ * Purpose: Smallest and largest value and their first positions
+ * Returns nullopt for an empty array.
+ */
+optional<MinMax> minMax(const int32_t* data, size_t n) {
+    if (n == 0) {
+        return nullopt;
+    }
+    MinMax result{data[0], data[0], 0, 0};
+    if (HAS_AVX2) {
+        minMaxValuesAVX2(data, n, result.min, result.max);
+        result.argmin = findFirstAVX2(data, n, result.min);
+        result.argmax = findFirstAVX2(data, n, result.max);
+    } else {
+        minMaxValuesScalar(data, n, result.min, result.max);
+        result.argmin = findFirstScalar(data, n, result.min);
+        result.argmax = findFirstScalar(data, n, result.max);
+    }
+    return result;
+}
+
+// ---------------------------------------------------------------------
+// Distinct values and duplicates
+// ---------------------------------------------------------------------
+
+/*
+ * Class: FlatIntSet
+ * Purpose: Open-addressing hash set of int32 values with a fixed
+ * capacity: one allocation, no node per element (unordered_set makes
+ * one per insert). Slots are int64_t so that EMPTY is not an int32.
+ */
+class FlatIntSet {
+    private:
+        static constexpr int64_t EMPTY = INT64_MIN;
+        AlignedVector<int64_t> slots;
+        unsigned shift;
+
+    public:
+        // Room for 'capacity' values with the table at most half full
+        // There are only 2^32 different int32 values, so at most 2^33 slots
+        explicit FlatIntSet(size_t capacity) {
+            uint64_t needed = 2 * min<uint64_t>(capacity, (uint64_t)1 << 32);
+            unsigned bits = 4;
+            while (((uint64_t)1 << bits) < needed) bits++;
+            slots.assign((size_t)1 << bits, EMPTY);
+            shift = 64 - bits;
+        }
+
+        // Returns false if the value was already present
+        bool insert(int32_t value) {
+            size_t mask = slots.size() - 1;
+            size_t slot = ((uint32_t)value * 0x9E3779B97F4A7C15ull) >> shift;  // Fibonacci hashing
+            while (slots[slot] != EMPTY) {
+                if (slots[slot] == value) {
+                    return false;
+                }
+                slot = (slot + 1) & mask;
+            }
+            slots[slot] = value;
+            return true;
+        }
+};
+
+// A bitmap over [min, max] is used while it needs at most 64 bits per
+// element, no more memory than the FlatIntSet it replaces
+bool useBitmap(const MinMax& range, size_t n) {
+    uint64_t span = (uint64_t)((int64_t)range.max - range.min) + 1;
+    return span <= 64 * (uint64_t)n;
+}
+
+/*
+ * Function: countDistinct
+ * Purpose: Number of different values in the array
+ */
+size_t countDistinct(const int32_t* data, size_t n) {
+    optional<MinMax> range = minMax(data, n);
+    if (!range) {
+        return 0;
+    }
+    if (useBitmap(*range, n)) {
+        uint64_t span = (uint64_t)((int64_t)range->max - range->min) + 1;
+        AlignedVector<uint64_t> seen((span + 63) / 64, 0);
+        for (size_t i = 0; i < n; i++) {
+            uint64_t bit = (uint64_t)((int64_t)data[i] - range->min);
+            seen[bit / 64] |= (uint64_t)1 << (bit % 64);
+        }
+        size_t distinct = 0;
+        for (uint64_t word : seen) distinct += __builtin_popcountll(word);
+        return distinct;
+    }
+    FlatIntSet seen(n);
+    size_t distinct = 0;
+    for (size_t i = 0; i < n; i++) distinct += seen.insert(data[i]);
+    return distinct;
+}
+
+/*
+ * Function: hasDuplicate
+ * Purpose: Whether any value occurs more than once
+ * Both versions stop at the first repeated value.
+ */
+bool hasDuplicate(const int32_t* data, size_t n) {
+    optional<MinMax> range = minMax(data, n);
+    if (!range) {
+        return false;
+    }
+    if (useBitmap(*range, n)) {
+        uint64_t span = (uint64_t)((int64_t)range->max - range->min) + 1;
+        if (span < n) {
+            return true;  // More values than possible different values
+        }
+        AlignedVector<uint64_t> seen((span + 63) / 64, 0);
+        for (size_t i = 0; i < n; i++) {
+            uint64_t bit = (uint64_t)((int64_t)data[i] - range->min);
+            uint64_t mask = (uint64_t)1 << (bit % 64);
+            if (seen[bit / 64] & mask) {
+                return true;
+            }
+            seen[bit / 64] |= mask;
+        }
+        return false;
+    }
+    FlatIntSet seen(n);
+    for (size_t i = 0; i < n; i++) {
+        if (!seen.insert(data[i])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// ---------------------------------------------------------------------
+// Iterating strings without copies
+// ---------------------------------------------------------------------
+
+/*
+ * Function: allocationsWhileIterating
+ * Purpose: Heap allocations made by visiting every name, by value (as in
+ * arr.cpp) or by const reference. Names longer than the small-string
+ * buffer (15 characters in libstdc++) allocate when copied.
+ */
+size_t allocationsWhileIterating(const vector<string>& names, bool byValue, size_t& totalLength) {
+    size_t before = allocations.load();
+    totalLength = 0;
+    if (byValue) {
+        for (string name : names) {
+            totalLength += name.size();
+        }
+    } else {
+        for (const string& name : names) {
+            totalLength += name.size();
+        }
+    }
+    return allocations.load() - before;
+}
+
+// ---------------------------------------------------------------------
+// Self-check and benchmark
+// ---------------------------------------------------------------------
+
+bool selfTest() {
+    mt19937 rng(11);
+    for (size_t n : {1, 7, 8, 9, 17, 100, 1001}) {
+        for (int32_t spread : {3, 1000, INT32_MAX}) {
+            AlignedVector<int32_t> data(n);
+            uniform_int_distribution<int32_t> values(-spread, spread);
+            for (int32_t& v : data) v = values(rng);
+
+            auto [low, high] = minmax_element(data.begin(), data.end());
+            MinMax mm = *minMax(data.data(), n);
+            // minmax_element returns the *last* largest element, so search for the first
+            size_t firstMax = find(data.begin(), data.end(), *high) - data.begin();
+            if (mm.min != *low || mm.argmin != (size_t)(low - data.begin()) || mm.max != *high ||
+                mm.argmax != firstMax) {
+                return false;
+            }
+            if (sumWide(data.data(), n) != accumulate(data.begin(), data.end(), (int64_t)0)) return false;
+            size_t distinct = unordered_set<int32_t>(data.begin(), data.end()).size();
+            if (countDistinct(data.data(), n) != distinct) return false;
+            if (hasDuplicate(data.data(), n) != (distinct < n)) return false;
+        }
+    }
+    return minMax(nullptr, 0) == nullopt && countDistinct(nullptr, 0) == 0 && !hasDuplicate(nullptr, 0);
+}
+
+template <typename F>
+double msPerCall(F f, size_t& allocationsPerCall) {
+    double best = 1e30;
+    for (int run = 0; run < 3; run++) {
+        size_t before = allocations.load();
+        auto start = chrono::steady_clock::now();
+        f();
+        best = min(best, chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+        allocationsPerCall = allocations.load() - before;
+    }
+    return best;
+}
+
+void report(const char* label, double ms, size_t allocationsPerCall, bool correct, const char* wrong = "  WRONG") {
+    cout << "    " << label << ms << " ms, " << allocationsPerCall << " allocations"
+         << (correct ? "" : wrong) << endl;
+}
+
+void benchmark(size_t n) {
+    mt19937 rng(3);
+    AlignedVector<int32_t> randomValues(n), permutation(n);
+    for (int32_t& v : randomValues) v = (int32_t)rng();
+    iota(permutation.begin(), permutation.end(), 0);
+    shuffle(permutation.begin(), permutation.end(), rng);
+
+    cout << "Statistics over " << n << " int32 values (best of 3, " << (HAS_AVX2 ? "AVX2" : "scalar")
+         << " kernels):" << endl;
+    size_t allocs;
+    const int32_t* data = randomValues.data();
+
+    cout << "  sum of random values:" << endl;
+    int64_t expected = accumulate(randomValues.begin(), randomValues.end(), (int64_t)0);
+    int intTotal = 0;
+    double ms = msPerCall([&] {
+        intTotal = 0;
+        for (size_t i = 0; i < n; i++) intTotal = (int)((unsigned)intTotal + (unsigned)data[i]);  // Wraps like int
+    }, allocs);
+    report("int total (arr.cpp style):   ", ms, allocs, intTotal == expected, "  (overflowed)");
+    int64_t total = 0;
+    ms = msPerCall([&] { total = accumulate(randomValues.begin(), randomValues.end(), (int64_t)0); }, allocs);
+    report("accumulate into int64_t:     ", ms, allocs, total == expected);
+    ms = msPerCall([&] { total = sumWide(data, n); }, allocs);
+    report("sumWide:                     ", ms, allocs, total == expected);
+
+    cout << "  smallest value and its position:" << endl;
+    size_t position = 0, expectedPosition = min_element(randomValues.begin(), randomValues.end()) - randomValues.begin();
+    ms = msPerCall([&] { position = minmax_element(randomValues.begin(), randomValues.end()).first - randomValues.begin(); }, allocs);
+    report("minmax_element:              ", ms, allocs, position == expectedPosition);
+    ms = msPerCall([&] { position = minMax(data, n)->argmin; }, allocs);
+    report("minMax:                      ", ms, allocs, position == expectedPosition);
+
+    for (bool small : {false, true}) {
+        const AlignedVector<int32_t>& values = small ? permutation : randomValues;
+        cout << (small ? "  distinct values, shuffled 0..n-1 (bitmap):" : "  distinct values, random int32 (hash set):")
+             << endl;
+        size_t distinct = 0, expectedDistinct = 0;
+        bool duplicate = false;
+        ms = msPerCall([&] { expectedDistinct = unordered_set<int32_t>(values.begin(), values.end()).size(); }, allocs);
+        report("unordered_set size:          ", ms, allocs, true);
+        ms = msPerCall([&] { distinct = countDistinct(values.data(), n); }, allocs);
+        report("countDistinct:               ", ms, allocs, distinct == expectedDistinct);
+        ms = msPerCall([&] {
+            unordered_set<int32_t> seen;
+            duplicate = false;
+            for (int32_t v : values) {
+                if (!seen.insert(v).second) {
+                    duplicate = true;
+                    break;
+                }
+            }
+        }, allocs);
+        report("unordered_set duplicate scan:", ms, allocs, duplicate == (expectedDistinct < n));
+        ms = msPerCall([&] { duplicate = hasDuplicate(values.data(), n); }, allocs);
+        report("hasDuplicate:                ", ms, allocs, duplicate == (expectedDistinct < n));
+    }
+}
+
+int main(int argc, char* argv[]) {
+
+    // The array from arr.cpp
+    int32_t arr[10] = {0, 1, 2, 3, 4, 5, 5, 6, 6, 9};
+    size_t count = sizeof(arr) / sizeof(arr[0]);
+    MinMax mm = *minMax(arr, count);
+    cout << "arr: sum " << sumWide(arr, count) << ", min " << mm.min << " at " << mm.argmin << ", max " << mm.max
+         << " at " << mm.argmax << ", " << countDistinct(arr, count) << " distinct, duplicates: "
+         << (hasDuplicate(arr, count) ? "yes" : "no") << endl;
+
+    AlignedVector<int32_t> aligned(100);
+    cout << "AlignedVector data on a 64-byte boundary: "
+         << ((uintptr_t)aligned.data() % 64 == 0 ? "yes" : "no") << endl;
+
+    // The cars from arr.cpp, with full model names
+    vector<string> cars = {"Shelby Cobra 427 Roadster", "Ford Mustang Mach 1", "BMW M3 Competition Touring",
+                           "Range Rover Sport Autobiography", "Volvo XC90 Recharge Ultimate"};
+    size_t lengthByValue = 0, lengthByReference = 0;
+    size_t copies = allocationsWhileIterating(cars, true, lengthByValue);
+    size_t references = allocationsWhileIterating(cars, false, lengthByReference);
+    cout << "Allocations iterating " << cars.size() << " car names: by value " << copies << ", by const reference "
+         << references << endl;
+    bool passed = selfTest() && references == 0 && lengthByValue == lengthByReference;
+    cout << "Self-test: " << (passed ? "passed" : "FAILED") << endl << endl;
+
+    size_t n = 2000000;
+    if (argc > 1) {
+        n = strtoul(argv[1], nullptr, 10);
+    }
+    benchmark(n);
+
+    /*
+     * Key Learning Points:
+     * 1. Widen before adding: int sums of int data overflow quickly
+     * 2. SIMD min/max plus a SIMD search finds the position too
+     * 3. A bitmap beats a hash set when the value range is small
+     * 4. A flat hash table needs one allocation, not one per element
+     * 5. Iterate with const references to avoid a copy per element
+     */
+
+    return 0;
+}
@@ -0,0 +1,120 @@
+/*
+ * C++ Example Function Benchmarks
+ * ===============================
+ *
+ * Runs the microbench.h harness over functions from the basic examples,
+ * compiled from their own source files with each main() renamed:
+ * - reverseString() from functions.cpp (it also prints its result)
+ * - rgbToString() from RGB.cpp
+ * - sum() from recursion.cpp
+ * - Car::print() from class_constructor.cpp
+ * Output that the functions print goes to a stream buffer that discards
+ * it, so the numbers measure formatting, not the terminal.
+ *
+ * Concept: With one shared harness every function is measured the same
+ * way, and a saved JSON file makes a before/after comparison one command:
+ *   make bench-baseline       # save bench_baseline.json
+ *   (change something)
+ *   make bench BASELINE=bench_baseline.json
+ *
+ * Usage: ./microbench [--filter text] [--json file] [--csv file] [--baseline file] ...
+ */
+
+#include <iostream>      // For input/output operations
+#include <streambuf>     // For the discarding stream buffer
+#include <string>        // For string class
+#include "microbench.h"  // For BenchRunner and doNotOptimize
+using namespace std;
+
+// The examples themselves, each with its main() renamed so that this file
+// can have its own. The standard headers they use are included above, so
+// the renaming cannot reach into them.
+#define main functions_main
+#include "functions.cpp"          // For reverseString
+#undef main
+
+#define main rgb_main
+#include "RGB.cpp"                // For RGB and rgbToString
+#undef main
+
+// recursion.cpp's main() has no return statement, which only main() may omit
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wreturn-type"
+#define main recursion_main
+#include "recursion.cpp"          // For sum
+#undef main
+#pragma GCC diagnostic pop
+
+#define main constructor_main
+#include "class_constructor.cpp"  // For Car
+#undef main
+
+/*
+ * Class: NullBuffer
+ * Purpose: A stream buffer that accepts and drops all output
+ */
+class NullBuffer : public streambuf {
+    protected:
+        int overflow(int c) override { return c == EOF ? 0 : c; }
+        streamsize xsputn(const char*, streamsize n) override { return n; }
+};
+
+NullBuffer nullBuffer;
+
+/*
+ * Class: DiscardCout
+ * Purpose: Sends cout to nullBuffer for as long as it exists
+ */
+class DiscardCout {
+    private:
+        streambuf* saved;
+
+    public:
+        DiscardCout() : saved(cout.rdbuf(&nullBuffer)) {}
+        ~DiscardCout() { cout.rdbuf(saved); }
+};
+
+int main(int argc, char* argv[]) {
+
+    BenchRunner runner;
+
+    // Inputs live in variables the compiler cannot see through
+    string shortText = "Stop Everything";
+    string longText(1000, 'x');
+    for (size_t i = 0; i < longText.size(); i++) longText[i] = (char)('a' + i % 26);
+    volatile int colours[3] = {RED, GREEN, BLUE};
+    volatile int depths[2] = {10, 1000};
+    Car car("Range Rover", "Sport", 2025);
+
+    runner.add("reverseString/15 bytes", [&](size_t) {
+        DiscardCout quiet;
+        reverseString(shortText);
+        doNotOptimize(shortText);
+    });
+    runner.add("reverseString/1000 bytes", [&](size_t) {
+        DiscardCout quiet;
+        reverseString(longText);
+        doNotOptimize(longText);
+    });
+    runner.add("rgbToString", [&](size_t i) {
+        string name = rgbToString((RGB)colours[i % 3]);
+        doNotOptimize(name);
+    });
+    runner.add("sum/10", [&](size_t) { doNotOptimize(sum(depths[0])); });
+    runner.add("sum/1000", [&](size_t) { doNotOptimize(sum(depths[1])); });
+    runner.add("Car::print", [&](size_t) {
+        DiscardCout quiet;
+        car.print();
+    });
+
+    /*
+     * Key Learning Points:
+     * 1. Warm up first: the first calls pay for cold caches and page faults
+     * 2. Time batches of calls, sized so the clock's resolution does not matter
+     * 3. Report the median and a spread (MAD), not a single timing
+     * 4. Pinning to one CPU removes migrations from the measurement
+     * 5. Only call a change a regression when it is larger than the noise
+     */
+
+    return runner.main(argc, argv);
+}
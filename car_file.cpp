@@ -0,0 +1,491 @@
+/*
+ * C++ Memory-Mapped Fleet File Examples
+ * =====================================
+ *
+ * This file demonstrates a binary file format that is used in place:
+ * - FleetWriter collects cars and writes a versioned binary file
+ * - FleetFile maps the file into memory with mmap() and checks it
+ * - Queries read years and names straight out of the mapped bytes
+ * - A benchmark compares startup against parsing text into Car objects
+ *
+ * File layout (all sections 8-byte aligned, little-endian):
+ *
+ *   Header     magic "CARFLEET", version, byte-order mark, counts,
+ *              section offsets and an FNV-1a checksum of the whole file
+ *              (computed with the checksum field itself set to zero)
+ *   years      int32  x cars    (fixed-width year column)
+ *   brandIds   uint32 x cars    (index into the string table)
+ *   modelIds   uint32 x cars
+ *   strOffsets uint32 x (strings + 1)   string i is [off[i], off[i+1])
+ *   strData    the characters of every distinct brand/model, back to back
+ *
+ * Concept: Building millions of Car objects at startup means millions of
+ * allocations and string copies. If the file already has the layout we
+ * want in memory, mmap() just maps it and the OS loads pages on demand.
+ *
+ * Usage: ./fleetfile [cars]   (default: 2000000)
+ */
+
+#include <chrono>         // For timing the benchmark
+#include <cstddef>        // For offsetof
+#include <cstdint>        // For fixed-width integer types
+#include <cstdio>         // For remove()
+#include <cstdlib>        // For strtoul
+#include <cstring>        // For memcmp/memcpy
+#include <fstream>        // For writing files and the text baseline
+#include <iostream>       // For input/output operations
+#include <string>         // For string class
+#include <string_view>    // For names read from the mapped file
+#include <unordered_map>  // For interning names in the writer
+#include <vector>         // For column buffers
+#include <fcntl.h>        // For open()
+#include <sys/mman.h>     // For mmap()/munmap()
+#include <sys/stat.h>     // For fstat()
+#include <unistd.h>       // For close()
+using namespace std;
+
+const char FLEET_MAGIC[8] = {'C', 'A', 'R', 'F', 'L', 'E', 'E', 'T'};
+const uint32_t FLEET_VERSION = 2;  // 2: the checksum also covers the header
+const uint32_t FLEET_BYTE_ORDER = 0x01020304;
+
+struct FleetHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint64_t cars;
+    uint64_t strings;
+    uint64_t yearsOffset;
+    uint64_t brandIdsOffset;
+    uint64_t modelIdsOffset;
+    uint64_t strOffsetsOffset;
+    uint64_t strDataOffset;
+    uint64_t fileSize;
+    uint64_t checksum;
+};
+
+// FNV-1a: a tiny, well-known 64-bit hash, good enough to catch corruption
+// Pass the previous result as 'hash' to continue over more bytes
+uint64_t fnv1a(const unsigned char* data, size_t size, uint64_t hash = 1469598103934665603ull) {
+    for (size_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+/*
+ * Function: fleetChecksum
+ * Purpose: Checksum of a whole fleet file: the header with its checksum
+ * field zeroed, then every byte after the header
+ */
+uint64_t fleetChecksum(const unsigned char* file, size_t size) {
+    FleetHeader header;
+    memcpy(&header, file, sizeof(header));
+    header.checksum = 0;
+    uint64_t hash = fnv1a((const unsigned char*)&header, sizeof(header));
+    return fnv1a(file + sizeof(FleetHeader), size - sizeof(FleetHeader), hash);
+}
+
+// Whether 'count' items of 'itemSize' bytes starting at 'offset' lie
+// inside a file of 'size' bytes, 4-byte aligned and after the header.
+// Written so that no sum can wrap around, whatever the header says.
+bool sectionFits(uint64_t offset, uint64_t count, uint64_t itemSize, uint64_t size) {
+    return offset >= sizeof(FleetHeader) && offset <= size && offset % 4 == 0 &&
+           count <= (size - offset) / itemSize;
+}
+
+size_t align8(size_t n) {
+    return (n + 7) & ~(size_t)7;
+}
+
+/*
+ * Class: FleetWriter
+ * Purpose: Collects cars as columns and writes them in the binary format
+ */
+class FleetWriter {
+    private:
+        vector<int32_t> years;
+        vector<uint32_t> brandIds;
+        vector<uint32_t> modelIds;
+        vector<string> strings;
+        unordered_map<string, uint32_t> ids;
+
+        uint32_t intern(const string& text);
+
+    public:
+        void add(const string& x, const string& y, int z);
+        bool write(const string& path, string& error) const;
+};
+
+uint32_t FleetWriter::intern(const string& text) {
+    auto found = ids.find(text);
+    if (found != ids.end()) {
+        return found->second;
+    }
+    uint32_t id = (uint32_t)strings.size();
+    strings.push_back(text);
+    ids.emplace(text, id);
+    return id;
+}
+
+void FleetWriter::add(const string& x, const string& y, int z) {
+    years.push_back(z);
+    brandIds.push_back(intern(x));
+    modelIds.push_back(intern(y));
+}
+
+/*
+ * Function: FleetWriter::write
+ * Purpose: Lays out every section in one buffer, checksums it, and writes
+ * it out. Returns false and fills 'error' if the file cannot be written.
+ */
+bool FleetWriter::write(const string& path, string& error) const {
+    FleetHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, FLEET_MAGIC, sizeof(FLEET_MAGIC));
+    header.version = FLEET_VERSION;
+    header.byteOrder = FLEET_BYTE_ORDER;
+    header.cars = years.size();
+    header.strings = strings.size();
+
+    size_t pos = align8(sizeof(FleetHeader));
+    header.yearsOffset = pos;
+    pos = align8(pos + years.size() * sizeof(int32_t));
+    header.brandIdsOffset = pos;
+    pos = align8(pos + brandIds.size() * sizeof(uint32_t));
+    header.modelIdsOffset = pos;
+    pos = align8(pos + modelIds.size() * sizeof(uint32_t));
+    header.strOffsetsOffset = pos;
+    pos = align8(pos + (strings.size() + 1) * sizeof(uint32_t));
+    header.strDataOffset = pos;
+
+    vector<uint32_t> offsets;
+    uint32_t chars = 0;
+    for (const string& s : strings) {
+        offsets.push_back(chars);
+        chars += (uint32_t)s.size();
+    }
+    offsets.push_back(chars);
+    header.fileSize = align8(pos + chars);
+
+    vector<unsigned char> file(header.fileSize, 0);
+    memcpy(&file[header.yearsOffset], years.data(), years.size() * sizeof(int32_t));
+    memcpy(&file[header.brandIdsOffset], brandIds.data(), brandIds.size() * sizeof(uint32_t));
+    memcpy(&file[header.modelIdsOffset], modelIds.data(), modelIds.size() * sizeof(uint32_t));
+    memcpy(&file[header.strOffsetsOffset], offsets.data(), offsets.size() * sizeof(uint32_t));
+    size_t at = header.strDataOffset;
+    for (const string& s : strings) {
+        memcpy(&file[at], s.data(), s.size());
+        at += s.size();
+    }
+    memcpy(&file[0], &header, sizeof(header));
+    header.checksum = fleetChecksum(file.data(), file.size());
+    memcpy(&file[0], &header, sizeof(header));
+
+    ofstream out(path, ios::binary | ios::trunc);
+    out.write((const char*)file.data(), file.size());
+    if (!out) {
+        error = "cannot write " + path;
+        return false;
+    }
+    return true;
+}
+
+/*
+ * Class: FleetFile
+ * Purpose: A read-only, memory-mapped fleet file
+ * open() checks the header and the section bounds, which is cheap and
+ * makes the year column safe to scan. verify() additionally checksums the
+ * whole file and checks every string id and offset, which reads all pages;
+ * run it before trusting names from a file you did not write yourself.
+ */
+class FleetFile {
+    private:
+        const unsigned char* base;
+        size_t mappedSize;
+        const FleetHeader* header;
+        const int32_t* years;
+        const uint32_t* brandIds;
+        const uint32_t* modelIds;
+        const uint32_t* strOffsets;
+        const char* strData;
+
+        void close();
+
+    public:
+        FleetFile() : base(nullptr), mappedSize(0), header(nullptr) {}
+        ~FleetFile() { close(); }
+        FleetFile(const FleetFile&) = delete;
+        FleetFile& operator=(const FleetFile&) = delete;
+
+        bool open(const string& path, string& error);
+        bool verify(string& error) const;
+
+        size_t size() const { return header->cars; }
+        int getYear(size_t i) const { return years[i]; }
+        string_view getBrand(size_t i) const { return name(brandIds[i]); }
+        string_view getModel(size_t i) const { return name(modelIds[i]); }
+        string_view name(uint32_t id) const {
+            return string_view(strData + strOffsets[id], strOffsets[id + 1] - strOffsets[id]);
+        }
+
+        size_t countYearRange(int from, int to) const;
+};
+
+void FleetFile::close() {
+    if (base != nullptr) {
+        munmap((void*)base, mappedSize);
+        base = nullptr;
+        header = nullptr;
+    }
+}
+
+bool FleetFile::open(const string& path, string& error) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = "cannot open " + path;
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(FleetHeader)) {
+        ::close(fd);
+        error = "file too small for a fleet header";
+        return false;
+    }
+    mappedSize = info.st_size;
+    void* mapped = mmap(nullptr, mappedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // The mapping stays valid after the descriptor is closed
+    if (mapped == MAP_FAILED) {
+        error = "mmap failed";
+        return false;
+    }
+    base = (const unsigned char*)mapped;
+    header = (const FleetHeader*)base;
+
+    // Structural checks: every section must lie inside the file
+    const FleetHeader& h = *header;
+    bool ok = memcmp(h.magic, FLEET_MAGIC, sizeof(FLEET_MAGIC)) == 0;
+    if (!ok) {
+        error = "bad magic";
+    } else if (h.version != FLEET_VERSION) {
+        error = "unsupported version " + to_string(h.version);
+    } else if (h.byteOrder != FLEET_BYTE_ORDER) {
+        error = "file was written with a different byte order";
+    } else if (h.fileSize != mappedSize) {
+        error = "file size does not match header (truncated?)";
+    } else if (h.strings >= mappedSize / 4 ||
+               !sectionFits(h.yearsOffset, h.cars, sizeof(int32_t), mappedSize) ||
+               !sectionFits(h.brandIdsOffset, h.cars, sizeof(uint32_t), mappedSize) ||
+               !sectionFits(h.modelIdsOffset, h.cars, sizeof(uint32_t), mappedSize) ||
+               !sectionFits(h.strOffsetsOffset, h.strings + 1, sizeof(uint32_t), mappedSize) ||
+               !sectionFits(h.strDataOffset, 0, 1, mappedSize)) {
+        error = "section offsets out of range";
+    } else {
+        years = (const int32_t*)(base + h.yearsOffset);
+        brandIds = (const uint32_t*)(base + h.brandIdsOffset);
+        modelIds = (const uint32_t*)(base + h.modelIdsOffset);
+        strOffsets = (const uint32_t*)(base + h.strOffsetsOffset);
+        strData = (const char*)(base + h.strDataOffset);
+        if (strOffsets[h.strings] > mappedSize - h.strDataOffset) {
+            error = "string table out of range";
+        } else {
+            return true;
+        }
+    }
+    close();
+    return false;
+}
+
+bool FleetFile::verify(string& error) const {
+    if (fleetChecksum(base, mappedSize) != header->checksum) {
+        error = "checksum mismatch";
+        return false;
+    }
+    for (uint64_t s = 0; s < header->strings; s++) {
+        if (strOffsets[s] > strOffsets[s + 1]) {
+            error = "string offsets not increasing";
+            return false;
+        }
+    }
+    for (uint64_t i = 0; i < header->cars; i++) {
+        if (brandIds[i] >= header->strings || modelIds[i] >= header->strings) {
+            error = "string id out of range at car " + to_string(i);
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t FleetFile::countYearRange(int from, int to) const {
+    if (to < from) {
+        return 0;  // Empty range; the unsigned width below would wrap
+    }
+    const unsigned width = (unsigned)to - (unsigned)from;
+    size_t count = 0;
+    for (size_t i = 0; i < header->cars; i++) {
+        count += ((unsigned)years[i] - (unsigned)from) <= width;
+    }
+    return count;
+}
+
+// The Car from access_specifier.cpp, used for the text-loading baseline
+class Car {
+    private:
+        string brand;
+        string model;
+        int year;
+
+    public:
+        Car(string x, string y, int z) {
+            brand = x;
+            model = y;
+            year = z;
+        }
+
+        int getYear() { return year; }
+};
+
+double millisSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+/*
+ * Function: benchmark
+ * Purpose: Writes the same fleet as text and as a binary file, then times
+ * "start up and answer one query" for each.
+ */
+void benchmark(size_t count) {
+    const string brands[] = {"Ford", "BMW", "Chevrolet", "Range Rover", "Volvo", "Ferrari"};
+    const string models[] = {"Mustang", "M5", "Camaro", "Sport", "XC90", "488"};
+    const string textPath = "fleet_bench.txt";
+    const string binPath = "fleet_bench.bin";
+
+    FleetWriter writer;
+    {
+        ofstream text(textPath);
+        for (size_t i = 0; i < count; i++) {
+            int b = (int)(i * 7 % 6);
+            int year = 1960 + (int)(i * 31 % 66);
+            text << brands[b] << ',' << models[b] << ',' << year << '\n';
+            writer.add(brands[b], models[b], year);
+        }
+    }
+    string error;
+    if (!writer.write(binPath, error)) {
+        cout << "Write failed: " << error << endl;
+        return;
+    }
+
+    cout << "Startup with " << count << " cars:" << endl;
+
+    // Text baseline: parse every line and construct a Car for it
+    auto start = chrono::steady_clock::now();
+    size_t textHits = 0;
+    {
+        ifstream text(textPath);
+        vector<Car> cars;
+        string brand, model, year;
+        while (getline(text, brand, ',') && getline(text, model, ',') && getline(text, year)) {
+            cars.push_back(Car(brand, model, stoi(year)));
+        }
+        for (Car& car : cars) {
+            textHits += car.getYear() >= 2013 && car.getYear() <= 2021;
+        }
+    }
+    double textMs = millisSince(start);
+
+    start = chrono::steady_clock::now();
+    size_t binHits = 0;
+    {
+        FleetFile file;
+        if (!file.open(binPath, error)) {
+            cout << "Open failed: " << error << endl;
+            return;
+        }
+        binHits = file.countYearRange(2013, 2021);
+    }
+    double binMs = millisSince(start);
+
+    start = chrono::steady_clock::now();
+    bool verified = false;
+    {
+        FleetFile file;
+        verified = file.open(binPath, error) && file.verify(error);
+    }
+    double verifyMs = millisSince(start);
+
+    cout << "  Text + Car objects:     " << textMs << " ms (" << textHits << " hits)" << endl;
+    cout << "  mmap + in-place query:  " << binMs << " ms (" << binHits << " hits)" << endl;
+    cout << "  mmap + full verify:     " << verifyMs << " ms ("
+         << (verified ? "ok" : error) << ")" << endl;
+    cout << "  Startup speedup:        " << textMs / binMs << "x" << endl << endl;
+
+    remove(textPath.c_str());
+    remove(binPath.c_str());
+}
+
+int main(int argc, char* argv[]) {
+
+    FleetWriter writer;
+    writer.add("Ford", "Mustang", 2013);
+    writer.add("BMW", "M5", 2020);
+    writer.add("Chevrolet", "Camaro", 2021);
+
+    string error;
+    if (!writer.write("fleet_demo.bin", error)) {
+        cout << "Write failed: " << error << endl;
+        return 1;
+    }
+
+    FleetFile file;
+    if (file.open("fleet_demo.bin", error) && file.verify(error)) {
+        for (size_t i = 0; i < file.size(); i++) {
+            cout << file.getBrand(i) << " " << file.getModel(i) << " " << file.getYear(i) << endl;
+        }
+        cout << "Cars from 2013 to 2021: " << file.countYearRange(2013, 2021)
+             << ", from 2021 to 2013: " << file.countYearRange(2021, 2013) << endl;
+    } else {
+        cout << "Open failed: " << error << endl;
+    }
+
+    // Flip one byte in the year column: verify() must notice
+    {
+        fstream corrupt("fleet_demo.bin", ios::in | ios::out | ios::binary);
+        corrupt.seekp(align8(sizeof(FleetHeader)));
+        corrupt.put('\x7f');
+    }
+    FleetFile damaged;
+    bool accepted = damaged.open("fleet_demo.bin", error) && damaged.verify(error);
+    cout << "Corrupted file: " << (accepted ? "accepted (BUG!)" : "rejected, " + error) << endl;
+
+    // A crafted header: yearsOffset + cars * 4 wraps around to a small number
+    writer.write("fleet_demo.bin", error);
+    {
+        fstream crafted("fleet_demo.bin", ios::in | ios::out | ios::binary);
+        uint64_t hugeOffset = UINT64_MAX - 7;
+        crafted.seekp(offsetof(FleetHeader, yearsOffset));
+        crafted.write((const char*)&hugeOffset, sizeof(hugeOffset));
+    }
+    accepted = damaged.open("fleet_demo.bin", error);
+    cout << "Crafted offsets: " << (accepted ? "accepted (BUG!)" : "rejected, " + error) << endl;
+    cout << endl;
+    remove("fleet_demo.bin");
+
+    size_t count = 2000000;
+    if (argc > 1) {
+        count = strtoul(argv[1], nullptr, 10);
+    }
+    benchmark(count);
+
+    /*
+     * Key Learning Points:
+     * 1. A file laid out like memory can be used without parsing it
+     * 2. mmap() maps a file into the address space; pages load on demand
+     * 3. Magic numbers, versions and byte-order marks reject foreign files
+     * 4. Always bounds-check offsets read from a file before following them
+     * 5. A checksum catches silent corruption but costs a full read
+     */
+
+    return 0;
+}
@@ -0,0 +1,314 @@
+/*
+ * C++ Columnar Car Fleet Examples
+ * ===============================
+ *
+ * This file demonstrates a "structure of arrays" (columnar) layout:
+ * - The Car class from access_specifier.cpp stores one car per object
+ * - CarFleet stores every brand, model and year in its own column
+ * - A row view gives back Car-style getBrand/getModel/getYear access
+ * - A benchmark compares year-range filtering over both layouts
+ *
+ * Concept: When a loop only needs one field (the year), a vector<Car>
+ * still drags both strings of every car through the cache. Keeping the
+ * years in one contiguous vector<int> means the loop touches only the
+ * bytes it needs, and the compiler can vectorise it (SIMD).
+ *
+ * Usage: ./fleet [rows...]   (default: 1000000 10000000)
+ */
+
+#include <chrono>    // For timing the benchmark
+#include <cstdlib>   // For strtoul
+#include <iostream>  // For input/output operations
+#include <random>    // For generating test fleets
+#include <string>    // For string class
+#include <vector>    // For the column storage
+using namespace std;
+
+// The row-oriented Car, exactly as in access_specifier.cpp
+class Car {
+    private:
+        string brand;
+        string model;
+        int year;
+
+    public:
+        Car(string x, string y, int z);
+
+        //Getter methods
+        string getBrand();
+        string getModel();
+        int getYear();
+};
+
+Car::Car(string x, string y, int z) {
+    brand = x;
+    model = y;
+    year = z;
+}
+
+string Car::getBrand() {
+    return brand;
+}
+
+string Car::getModel() {
+    return model;
+}
+
+int Car::getYear() {
+    return year;
+}
+
+class CarFleet;
+
+/*
+ * Class: CarRow
+ * Purpose: A lightweight view of one row of a CarFleet
+ * It only holds a pointer to the fleet and an index, so it is cheap to
+ * copy, and it reads straight out of the columns (no string copies).
+ */
+class CarRow {
+    private:
+        const CarFleet* fleet;
+        size_t index;
+
+    public:
+        CarRow(const CarFleet* f, size_t i) : fleet(f), index(i) {}
+
+        const string& getBrand() const;
+        const string& getModel() const;
+        int getYear() const;
+
+        void print() const;
+};
+
+/*
+ * Class: CarFleet
+ * Purpose: Stores many cars as three separate columns
+ * Column i of each vector together describes car number i.
+ */
+class CarFleet {
+    private:
+        vector<string> brands;
+        vector<string> models;
+        vector<int> years;   // Contiguous, so year scans can use SIMD
+
+    public:
+        void reserve(size_t n);
+        void add(const string& x, const string& y, int z);
+        size_t size() const { return years.size(); }
+
+        //Getter methods (by row number)
+        const string& getBrand(size_t i) const { return brands[i]; }
+        const string& getModel(size_t i) const { return models[i]; }
+        int getYear(size_t i) const { return years[i]; }
+
+        //Setter methods (by row number)
+        void setBrand(size_t i, const string& x) { brands[i] = x; }
+        void setModel(size_t i, const string& y) { models[i] = y; }
+        void setYear(size_t i, int z) { years[i] = z; }
+
+        CarRow row(size_t i) const { return CarRow(this, i); }
+
+        // Direct access to the year column for bulk processing
+        const int* yearData() const { return years.data(); }
+
+        size_t countYearRange(int from, int to) const;
+        void filterYearRange(int from, int to, vector<size_t>& out) const;
+};
+
+const string& CarRow::getBrand() const {
+    return fleet->getBrand(index);
+}
+
+const string& CarRow::getModel() const {
+    return fleet->getModel(index);
+}
+
+int CarRow::getYear() const {
+    return fleet->getYear(index);
+}
+
+void CarRow::print() const {
+    cout << "==========================" << endl;
+    cout << "|      Car Details       |" << endl;
+    cout << "==========================" << endl;
+    cout << "     Brand:  " << getBrand() << endl;
+    cout << "     Model:  " << getModel() << endl;
+    cout << "     Year:   " << getYear() << endl;
+    cout << "==========================" << endl << endl;
+}
+
+void CarFleet::reserve(size_t n) {
+    brands.reserve(n);
+    models.reserve(n);
+    years.reserve(n);
+}
+
+void CarFleet::add(const string& x, const string& y, int z) {
+    brands.push_back(x);
+    models.push_back(y);
+    years.push_back(z);
+}
+
+/*
+ * Function: CarFleet::countYearRange
+ * Purpose: Counts cars with from <= year <= to
+ * The range test is written without branches: subtracting 'from' and
+ * comparing as unsigned folds both bounds into one compare, and adding
+ * the bool result keeps the loop body straight-line so it vectorises.
+ */
+size_t CarFleet::countYearRange(int from, int to) const {
+    if (to < from) {
+        return 0;  // Empty range; the unsigned width below would wrap
+    }
+    const int* y = years.data();
+    const size_t n = years.size();
+    const unsigned width = (unsigned)to - (unsigned)from;
+    size_t count = 0;
+    for (size_t i = 0; i < n; i++) {
+        count += ((unsigned)y[i] - (unsigned)from) <= width;
+    }
+    return count;
+}
+
+/*
+ * Function: CarFleet::filterYearRange
+ * Purpose: Collects the row numbers of cars with from <= year <= to
+ * Only the year column is read; brands and models are never touched.
+ */
+void CarFleet::filterYearRange(int from, int to, vector<size_t>& out) const {
+    const int* y = years.data();
+    const size_t n = years.size();
+    out.clear();
+    if (to < from) {
+        return;
+    }
+    const unsigned width = (unsigned)to - (unsigned)from;
+    for (size_t i = 0; i < n; i++) {
+        if (((unsigned)y[i] - (unsigned)from) <= width) {
+            out.push_back(i);
+        }
+    }
+}
+
+// Row-oriented baseline: walk every Car object and ask for its year
+void filterCars(vector<Car>& cars, int from, int to, vector<size_t>& out) {
+    out.clear();
+    for (size_t i = 0; i < cars.size(); i++) {
+        int year = cars[i].getYear();
+        if (year >= from && year <= to) {
+            out.push_back(i);
+        }
+    }
+}
+
+double millisSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+/*
+ * Function: benchmark
+ * Purpose: Builds the same random fleet in both layouts and times a
+ * year-range filter over each (best of several runs).
+ */
+void benchmark(size_t rows) {
+    const string brands[] = {"Ford", "BMW", "Chevrolet", "Range Rover", "Volvo", "Ferrari"};
+    const string models[] = {"Mustang", "M5", "Camaro", "Sport", "XC90", "488"};
+
+    mt19937 rng(42);
+    uniform_int_distribution<int> pick(0, 5);
+    uniform_int_distribution<int> yearDist(1960, 2025);
+
+    vector<Car> cars;
+    cars.reserve(rows);
+    CarFleet fleet;
+    fleet.reserve(rows);
+    for (size_t i = 0; i < rows; i++) {
+        int b = pick(rng);
+        int year = yearDist(rng);
+        cars.push_back(Car(brands[b], models[b], year));
+        fleet.add(brands[b], models[b], year);
+    }
+
+    const int from = 2013;
+    const int to = 2021;
+    const int runs = 5;
+    vector<size_t> hits;
+    double rowMs = 1e30;
+    double colMs = 1e30;
+    size_t rowHits = 0;
+    size_t colHits = 0;
+
+    for (int r = 0; r < runs; r++) {
+        auto start = chrono::steady_clock::now();
+        filterCars(cars, from, to, hits);
+        rowMs = min(rowMs, millisSince(start));
+        rowHits = hits.size();
+
+        start = chrono::steady_clock::now();
+        fleet.filterYearRange(from, to, hits);
+        colMs = min(colMs, millisSince(start));
+        colHits = hits.size();
+    }
+
+    double countMs = 1e30;
+    size_t counted = 0;
+    for (int r = 0; r < runs; r++) {
+        auto start = chrono::steady_clock::now();
+        counted = fleet.countYearRange(from, to);
+        countMs = min(countMs, millisSince(start));
+    }
+
+    cout << "Rows: " << rows << " (years " << from << "-" << to << ")" << endl;
+    cout << "  vector<Car> filter:      " << rowMs << " ms, " << rowHits << " hits" << endl;
+    cout << "  CarFleet filter:         " << colMs << " ms, " << colHits << " hits" << endl;
+    cout << "  CarFleet count (SIMD):   " << countMs << " ms, " << counted << " hits" << endl;
+    cout << "  Filter speedup:          " << rowMs / colMs << "x" << endl << endl;
+
+    if (rowHits != colHits || colHits != counted) {
+        cout << "  MISMATCH between layouts!" << endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    // Build a small fleet and use it just like the Car objects elsewhere
+    CarFleet fleet;
+    fleet.add("Ford", "Mustang", 2013);
+    fleet.add("BMW", "M5", 2020);
+    fleet.row(0).print();
+
+    fleet.setBrand(0, "Chevrolet");
+    fleet.setModel(0, "Camaro");
+    fleet.setYear(0, 2021);
+    fleet.row(0).print();
+
+    cout << "Cars from 2013-2021: " << fleet.countYearRange(2013, 2021) << endl;
+    vector<size_t> reversed;
+    fleet.filterYearRange(2021, 2013, reversed);
+    cout << "Cars from 2021-2013 (reversed range): " << fleet.countYearRange(2021, 2013) << " counted, "
+         << reversed.size() << " filtered" << endl << endl;
+
+    // Benchmark: row layout vs column layout
+    vector<size_t> sizes;
+    for (int i = 1; i < argc; i++) {
+        sizes.push_back(strtoul(argv[i], nullptr, 10));
+    }
+    if (sizes.empty()) {
+        sizes.push_back(1000000);
+        sizes.push_back(10000000);
+    }
+    for (size_t rows : sizes) {
+        benchmark(rows);
+    }
+
+    /*
+     * Key Learning Points:
+     * 1. vector<Car> is "array of structures": fields of one car sit together
+     * 2. CarFleet is "structure of arrays": one field of all cars sits together
+     * 3. Scans over one field only read that column, so far fewer cache misses
+     * 4. Branch-free loops over contiguous ints let the compiler use SIMD
+     * 5. A small view class (CarRow) keeps the familiar getter interface
+     */
+
+    return 0;
+}
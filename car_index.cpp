@@ -0,0 +1,312 @@
+/*
+ * C++ Secondary Index Examples
+ * ============================
+ *
+ * This file demonstrates indexes over a collection of Car objects:
+ * - A hash index (unordered_map) answers "all cars of brand X"
+ * - An ordered index (map, a balanced tree) answers "all cars from A to B"
+ * - setBrand/setYear go through the collection so the indexes stay correct
+ * - A benchmark compares indexed queries with a full scan as data grows
+ *
+ * Concept: Without an index every question walks all N cars (O(N)).
+ * An index spends some memory and some work on every update so that
+ * queries only touch the matching cars (O(1) or O(log N) + matches).
+ *
+ * Usage: ./index [cars...]   (default: 10000 100000 1000000)
+ */
+
+#include <chrono>         // For timing the benchmark
+#include <cstdlib>        // For strtoul
+#include <iostream>       // For input/output operations
+#include <map>            // Ordered year index
+#include <random>         // For generating test data
+#include <string>         // For string class
+#include <unordered_map>  // Hash brand index
+#include <vector>         // For storage and index buckets
+using namespace std;
+
+// The Car from access_specifier.cpp, read-only once it is in a collection
+class Car {
+    private:
+        string brand;
+        string model;
+        int year;
+
+    public:
+        Car(string x, string y, int z) : brand(x), model(y), year(z) {}
+
+        const string& getBrand() const { return brand; }
+        const string& getModel() const { return model; }
+        int getYear() const { return year; }
+
+        void print() const {
+            cout << "     " << brand << " " << model << " (" << year << ")" << endl;
+        }
+
+        friend class CarCollection;
+};
+
+/*
+ * Class: CarCollection
+ * Purpose: Owns the cars and keeps a brand index and a year index
+ *
+ * Each index maps a key to a "bucket" (vector of car ids). Every car also
+ * remembers where it sits inside its two buckets, so moving a car from one
+ * bucket to another is O(1): swap it with the bucket's last entry, pop it,
+ * and fix up the slot of the entry that was moved.
+ */
+class CarCollection {
+    private:
+        struct Slots {
+            size_t brandSlot;
+            size_t yearSlot;
+        };
+
+        vector<Car> cars;
+        vector<Slots> slots;
+        unordered_map<string, vector<size_t>> byBrand;
+        map<int, vector<size_t>> byYear;
+
+        static const vector<size_t> empty;
+
+        void unlinkBrand(size_t id);
+        void unlinkYear(size_t id);
+        void linkBrand(size_t id);
+        void linkYear(size_t id);
+
+    public:
+        size_t add(const string& x, const string& y, int z);
+        const Car& get(size_t id) const { return cars[id]; }
+        size_t size() const { return cars.size(); }
+
+        // Setters keep both indexes consistent
+        void setBrand(size_t id, const string& x);
+        void setModel(size_t id, const string& y) { cars[id].model = y; }
+        void setYear(size_t id, int z);
+
+        // Point query: ids of every car with this brand
+        const vector<size_t>& findBrand(const string& brand) const;
+
+        // Range query: ids of every car with from <= year <= to
+        void findYearRange(int from, int to, vector<size_t>& out) const;
+        size_t countYearRange(int from, int to) const;
+};
+
+const vector<size_t> CarCollection::empty;
+
+void CarCollection::linkBrand(size_t id) {
+    vector<size_t>& bucket = byBrand[cars[id].brand];
+    slots[id].brandSlot = bucket.size();
+    bucket.push_back(id);
+}
+
+void CarCollection::linkYear(size_t id) {
+    vector<size_t>& bucket = byYear[cars[id].year];
+    slots[id].yearSlot = bucket.size();
+    bucket.push_back(id);
+}
+
+void CarCollection::unlinkBrand(size_t id) {
+    auto found = byBrand.find(cars[id].brand);
+    vector<size_t>& bucket = found->second;
+    size_t moved = bucket.back();
+    bucket[slots[id].brandSlot] = moved;
+    slots[moved].brandSlot = slots[id].brandSlot;
+    bucket.pop_back();
+    if (bucket.empty()) {
+        byBrand.erase(found);
+    }
+}
+
+void CarCollection::unlinkYear(size_t id) {
+    auto found = byYear.find(cars[id].year);
+    vector<size_t>& bucket = found->second;
+    size_t moved = bucket.back();
+    bucket[slots[id].yearSlot] = moved;
+    slots[moved].yearSlot = slots[id].yearSlot;
+    bucket.pop_back();
+    if (bucket.empty()) {
+        byYear.erase(found);
+    }
+}
+
+size_t CarCollection::add(const string& x, const string& y, int z) {
+    size_t id = cars.size();
+    cars.push_back(Car(x, y, z));
+    slots.push_back(Slots());
+    linkBrand(id);
+    linkYear(id);
+    return id;
+}
+
+void CarCollection::setBrand(size_t id, const string& x) {
+    unlinkBrand(id);
+    cars[id].brand = x;
+    linkBrand(id);
+}
+
+void CarCollection::setYear(size_t id, int z) {
+    unlinkYear(id);
+    cars[id].year = z;
+    linkYear(id);
+}
+
+const vector<size_t>& CarCollection::findBrand(const string& brand) const {
+    auto found = byBrand.find(brand);
+    return found == byBrand.end() ? empty : found->second;
+}
+
+/*
+ * Function: CarCollection::findYearRange
+ * Purpose: Walks only the tree nodes whose year lies in [from, to]
+ * lower_bound finds the first year >= from in O(log Y); from there the
+ * tree is already sorted, so we stop as soon as a year exceeds 'to'.
+ */
+void CarCollection::findYearRange(int from, int to, vector<size_t>& out) const {
+    out.clear();
+    for (auto it = byYear.lower_bound(from); it != byYear.end() && it->first <= to; ++it) {
+        out.insert(out.end(), it->second.begin(), it->second.end());
+    }
+}
+
+size_t CarCollection::countYearRange(int from, int to) const {
+    size_t count = 0;
+    for (auto it = byYear.lower_bound(from); it != byYear.end() && it->first <= to; ++it) {
+        count += it->second.size();
+    }
+    return count;
+}
+
+// Full-scan baselines: what we had to do before the indexes existed
+size_t scanBrand(const CarCollection& c, const string& brand) {
+    size_t count = 0;
+    for (size_t i = 0; i < c.size(); i++) {
+        if (c.get(i).getBrand() == brand) {
+            count++;
+        }
+    }
+    return count;
+}
+
+void scanYearRange(const CarCollection& c, int from, int to, vector<size_t>& out) {
+    out.clear();
+    for (size_t i = 0; i < c.size(); i++) {
+        int year = c.get(i).getYear();
+        if (year >= from && year <= to) {
+            out.push_back(i);
+        }
+    }
+}
+
+double microsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+}
+
+/*
+ * Function: benchmark
+ * Purpose: Times point and range queries with and without the indexes
+ * on a collection of 'count' random cars (best of several runs).
+ */
+void benchmark(size_t count) {
+    // Many brands, so a single brand is a small fraction of the fleet
+    vector<string> brands;
+    for (int i = 0; i < 200; i++) {
+        brands.push_back("Brand" + to_string(i));
+    }
+
+    mt19937 rng(7);
+    uniform_int_distribution<size_t> pick(0, brands.size() - 1);
+    uniform_int_distribution<int> yearDist(1950, 2025);
+
+    CarCollection c;
+    for (size_t i = 0; i < count; i++) {
+        c.add(brands[pick(rng)], "Model", yearDist(rng));
+    }
+
+    const int runs = 5;
+    const string target = "Brand42";
+    vector<size_t> hits;
+    double indexPoint = 1e30, scanPoint = 1e30, indexRange = 1e30, scanRange = 1e30;
+    size_t pointIndexed = 0, pointScanned = 0, rangeIndexed = 0, rangeScanned = 0;
+
+    for (int r = 0; r < runs; r++) {
+        auto start = chrono::steady_clock::now();
+        pointIndexed = c.findBrand(target).size();
+        indexPoint = min(indexPoint, microsSince(start));
+
+        start = chrono::steady_clock::now();
+        pointScanned = scanBrand(c, target);
+        scanPoint = min(scanPoint, microsSince(start));
+
+        start = chrono::steady_clock::now();
+        c.findYearRange(2013, 2014, hits);
+        rangeIndexed = hits.size();
+        indexRange = min(indexRange, microsSince(start));
+
+        start = chrono::steady_clock::now();
+        scanYearRange(c, 2013, 2014, hits);
+        rangeScanned = hits.size();
+        scanRange = min(scanRange, microsSince(start));
+    }
+
+    cout << "Cars: " << count << endl;
+    cout << "  Brand point query:  index " << indexPoint << " us, scan " << scanPoint
+         << " us (" << pointIndexed << " hits)" << endl;
+    cout << "  Year range query:   index " << indexRange << " us, scan " << scanRange
+         << " us (" << rangeIndexed << " hits)" << endl;
+    if (pointIndexed != pointScanned || rangeIndexed != rangeScanned) {
+        cout << "  MISMATCH between index and scan!" << endl;
+    }
+    cout << endl;
+}
+
+int main(int argc, char* argv[]) {
+
+    CarCollection garage;
+    size_t mustang = garage.add("Ford", "Mustang", 2013);
+    garage.add("BMW", "M5", 2020);
+    garage.add("BMW", "X5", 2024);
+
+    cout << "All BMWs:" << endl;
+    for (size_t id : garage.findBrand("BMW")) {
+        garage.get(id).print();
+    }
+
+    // Updating through the collection keeps the indexes up to date
+    garage.setBrand(mustang, "Chevrolet");
+    garage.setModel(mustang, "Camaro");
+    garage.setYear(mustang, 2021);
+
+    vector<size_t> ids;
+    garage.findYearRange(2013, 2021, ids);
+    cout << "Cars from 2013-2021:" << endl;
+    for (size_t id : ids) {
+        garage.get(id).print();
+    }
+    cout << "Fords left: " << garage.findBrand("Ford").size() << endl << endl;
+
+    vector<size_t> sizes;
+    for (int i = 1; i < argc; i++) {
+        sizes.push_back(strtoul(argv[i], nullptr, 10));
+    }
+    if (sizes.empty()) {
+        sizes.push_back(10000);
+        sizes.push_back(100000);
+        sizes.push_back(1000000);
+    }
+    for (size_t count : sizes) {
+        benchmark(count);
+    }
+
+    /*
+     * Key Learning Points:
+     * 1. A hash index gives O(1) lookup by exact key (like "BMW")
+     * 2. An ordered index (std::map) also supports ranges via lower_bound
+     * 3. Indexes must be updated on every change, so setters go through
+     *    the collection instead of touching the Car directly
+     * 4. Remembering each entry's slot makes removal from a bucket O(1)
+     * 5. Scan cost grows with N; indexed query cost grows with the matches
+     */
+
+    return 0;
+}
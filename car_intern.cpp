@@ -0,0 +1,231 @@
+/*
+ * C++ String Interning Examples
+ * =============================
+ *
+ * This file demonstrates string interning for repeated Car values:
+ * - A StringPool stores each distinct brand/model text exactly once
+ * - Every distinct string gets a compact 32-bit id
+ * - The Car class holds ids instead of full std::string copies
+ * - Ids are turned back into string_view (no copy) for printing
+ *
+ * Concept: A fleet of millions of cars only has a few dozen different
+ * brands and models. Copying "Range Rover" into every Car wastes memory
+ * and time; storing a 4-byte id that points into a shared table does not.
+ *
+ * Usage: ./intern [cars]   (default: 10000000)
+ */
+
+#include <chrono>         // For timing the benchmark
+#include <cstdint>        // For uint32_t
+#include <cstdlib>        // For strtoul
+#include <deque>          // Stable storage for pooled strings
+#include <fstream>        // For reading /proc/self/status
+#include <iostream>       // For input/output operations
+#include <string>         // For string class
+#include <string_view>    // For non-owning string references (C++17)
+#include <unordered_map>  // For text -> id lookup
+#include <vector>         // For id -> text lookup
+using namespace std;
+
+/*
+ * Class: StringPool
+ * Purpose: Maps text to small integer ids and back
+ * Strings live in a deque, which never moves existing elements when it
+ * grows, so the string_views used as map keys always stay valid.
+ */
+class StringPool {
+    private:
+        deque<string> storage;
+        vector<string_view> byId;
+        unordered_map<string_view, uint32_t> ids;
+
+    public:
+        uint32_t intern(string_view text);
+        string_view lookup(uint32_t id) const { return byId[id]; }
+        size_t size() const { return byId.size(); }
+};
+
+/*
+ * Function: StringPool::intern
+ * Purpose: Returns the id for 'text', adding it to the pool if it is new
+ */
+uint32_t StringPool::intern(string_view text) {
+    auto found = ids.find(text);
+    if (found != ids.end()) {
+        return found->second;
+    }
+    storage.emplace_back(text);
+    string_view stored = storage.back();
+    uint32_t id = (uint32_t)byId.size();
+    byId.push_back(stored);
+    ids.emplace(stored, id);
+    return id;
+}
+
+/*
+ * Class: Car
+ * Purpose: Same interface as access_specifier.cpp, but brand and model
+ * are stored as ids into a pool shared by every Car (12 bytes per car).
+ */
+class Car {
+    private:
+        uint32_t brand;
+        uint32_t model;
+        int year;
+
+    public:
+        static StringPool names;
+
+        Car(string_view x, string_view y, int z);
+
+        void print() const;
+
+        //Getter methods
+        string_view getBrand() const { return names.lookup(brand); }
+        string_view getModel() const { return names.lookup(model); }
+        int getYear() const { return year; }
+
+        // Setter Method
+        void setBrand(string_view x) { brand = names.intern(x); }
+        void setModel(string_view y) { model = names.intern(y); }
+        void setYear(int z) { year = z; }
+
+        // Interned strings are equal exactly when their ids are equal
+        bool sameBrand(const Car& other) const { return brand == other.brand; }
+};
+
+StringPool Car::names;
+
+Car::Car(string_view x, string_view y, int z) {
+    brand = names.intern(x);
+    model = names.intern(y);
+    year = z;
+}
+
+void Car::print() const {
+    cout << "==========================" << endl;
+    cout << "|      Car Details       |" << endl;
+    cout << "==========================" << endl;
+    cout << "     Brand:  " << getBrand() << endl;
+    cout << "     Model:  " << getModel() << endl;
+    cout << "     Year:   " << getYear() << endl;
+    cout << "==========================" << endl << endl;
+}
+
+// The string-holding Car from access_specifier.cpp, used as the baseline
+class StringCar {
+    private:
+        string brand;
+        string model;
+        int year;
+
+    public:
+        StringCar(string x, string y, int z) {
+            brand = x;
+            model = y;
+            year = z;
+        }
+};
+
+// Reads the resident set size of this process in kilobytes (Linux only)
+long residentKB() {
+    ifstream status("/proc/self/status");
+    string key;
+    while (status >> key) {
+        if (key == "VmRSS:") {
+            long kb = 0;
+            status >> kb;
+            return kb;
+        }
+    }
+    return 0;
+}
+
+double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+/*
+ * Function: benchmark
+ * Purpose: Builds the same fleet with interned ids and with full strings,
+ * reporting construction throughput and resident memory growth for each.
+ * The interned fleet is built first so that memory kept by the allocator
+ * after the string fleet is freed cannot hide its real footprint.
+ */
+void benchmark(size_t count) {
+    // A realistic mix: a few short names and several longer than the
+    // small-string buffer, which forces a heap allocation per copy
+    const string brands[] = {"Ford", "BMW", "Chevrolet", "Range Rover",
+                             "Mercedes-Benz", "Aston Martin Lagonda"};
+    const string models[] = {"Mustang Shelby GT500", "M5 Competition",
+                             "Camaro ZL1 Convertible", "Sport Autobiography",
+                             "AMG GT Black Series", "DBS Superleggera Volante"};
+    const size_t kinds = 6;
+
+    cout << "Building " << count << " cars" << endl;
+
+    long before = residentKB();
+    auto start = chrono::steady_clock::now();
+    {
+        vector<Car> cars;
+        cars.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            cars.push_back(Car(brands[i % kinds], models[(i / kinds) % kinds], 1960 + (int)(i % 66)));
+        }
+        double seconds = secondsSince(start);
+        long grown = residentKB() - before;
+        cout << "  Interned Car:   " << count / seconds / 1e6 << " M cars/s, "
+             << grown / 1024 << " MB resident, " << sizeof(Car) << " bytes/object" << endl;
+    }
+
+    before = residentKB();
+    start = chrono::steady_clock::now();
+    {
+        vector<StringCar> cars;
+        cars.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            cars.push_back(StringCar(brands[i % kinds], models[(i / kinds) % kinds], 1960 + (int)(i % 66)));
+        }
+        double seconds = secondsSince(start);
+        long grown = residentKB() - before;
+        cout << "  std::string Car: " << count / seconds / 1e6 << " M cars/s, "
+             << grown / 1024 << " MB resident, " << sizeof(StringCar) << " bytes/object" << endl;
+    }
+
+    cout << "  Distinct strings in pool: " << Car::names.size() << endl << endl;
+}
+
+int main(int argc, char* argv[]) {
+
+    Car carObj1("Ford", "Mustang", 2013);
+    carObj1.print();
+
+    Car carObj2("BMW", "M5", 2020);
+    carObj2.print();
+
+    carObj1.setBrand("Chevrolet");
+    carObj1.setModel("Camaro");
+    carObj1.setYear(2021);
+    carObj1.print();
+
+    Car carObj3("BMW", "X5", 2024);
+    cout << "carObj2 and carObj3 share a brand id: "
+         << (carObj2.sameBrand(carObj3) ? "yes" : "no") << endl << endl;
+
+    size_t count = 10000000;
+    if (argc > 1) {
+        count = strtoul(argv[1], nullptr, 10);
+    }
+    benchmark(count);
+
+    /*
+     * Key Learning Points:
+     * 1. Interning stores each distinct string once and hands out ids
+     * 2. A Car of two ids and an int is 12 bytes instead of ~72 plus heap
+     * 3. string_view lets us read pooled text without copying it
+     * 4. Comparing two interned strings is just comparing two integers
+     * 5. deque keeps element addresses stable as it grows, vector does not
+     */
+
+    return 0;
+}
@@ -0,0 +1,406 @@
+/*
+ * C++ Parallel Query Examples
+ * ===========================
+ *
+ * This file demonstrates running queries over many Car objects on all
+ * CPU cores:
+ * - A work-stealing thread pool (one task deque per worker thread)
+ * - parallelChunks() splits a range into cache-sized chunks
+ * - count, filter and mapReduce queries built on top of it
+ * - A count-by-year benchmark at 1, 2, 4, ... workers against a plain loop
+ *
+ * Concept: Each worker pops tasks from the back of its own deque. A task
+ * covering many chunks splits itself in half and pushes one half back
+ * onto that deque. Idle workers "steal" from the front of other deques,
+ * which is where the biggest pieces of work are, so every core stays busy
+ * without a central queue that all threads fight over.
+ *
+ * Usage: ./parallel [cars] [max threads]   (default: 4000000 16)
+ */
+
+#include <algorithm>           // For min/max
+#include <atomic>              // For lock-free counters and flags
+#include <chrono>              // For timing the benchmark
+#include <condition_variable>  // For sleeping idle workers
+#include <cstdlib>             // For strtoul
+#include <deque>               // Per-worker task queues
+#include <functional>          // For std::function tasks
+#include <iostream>            // For input/output operations
+#include <memory>              // For unique_ptr
+#include <mutex>               // For protecting each deque
+#include <string>              // For string class
+#include <thread>              // For worker threads
+#include <vector>              // For storage
+using namespace std;
+
+// The Car from access_specifier.cpp (getters made const)
+class Car {
+    private:
+        string brand;
+        string model;
+        int year;
+
+    public:
+        Car(string x, string y, int z) : brand(x), model(y), year(z) {}
+
+        const string& getBrand() const { return brand; }
+        const string& getModel() const { return model; }
+        int getYear() const { return year; }
+};
+
+/*
+ * Class: ThreadPool
+ * Purpose: A fixed set of workers, each with its own task deque
+ * Tasks submitted from a worker go to that worker's deque; tasks from any
+ * other thread are spread round-robin. Each deque has its own small mutex,
+ * so threads only contend when one of them is stealing.
+ */
+class ThreadPool {
+    private:
+        struct Queue {
+            mutex lock;
+            deque<function<void()>> tasks;
+        };
+
+        vector<unique_ptr<Queue>> queues;
+        vector<thread> workers;
+        atomic<bool> stopping;
+        atomic<size_t> queued;
+        atomic<size_t> nextQueue;
+        mutex sleepLock;
+        condition_variable wake;
+
+        static thread_local int workerIndex;
+
+        bool popLocal(size_t q, function<void()>& task);
+        bool steal(size_t thief, function<void()>& task);
+        void workerLoop(size_t index);
+
+    public:
+        explicit ThreadPool(size_t threads);
+        ~ThreadPool();
+
+        size_t size() const { return workers.size(); }
+        void submit(function<void()> task);
+
+        // Runs one pending task on the calling thread, if there is one
+        bool runPending();
+};
+
+thread_local int ThreadPool::workerIndex = -1;
+
+ThreadPool::ThreadPool(size_t threads) : stopping(false), queued(0), nextQueue(0) {
+    threads = max<size_t>(threads, 1);
+    for (size_t i = 0; i < threads; i++) {
+        queues.emplace_back(new Queue());
+    }
+    for (size_t i = 0; i < threads; i++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> guard(sleepLock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (thread& t : workers) {
+        t.join();
+    }
+}
+
+void ThreadPool::submit(function<void()> task) {
+    size_t q = workerIndex >= 0 ? (size_t)workerIndex : nextQueue++ % queues.size();
+    {
+        // Counted before it is published, so a thread that pops the task
+        // straight away can never take 'queued' below zero. Taking the
+        // sleep lock orders this with a worker about to wait.
+        lock_guard<mutex> guard(sleepLock);
+        queued++;
+    }
+    {
+        lock_guard<mutex> guard(queues[q]->lock);
+        queues[q]->tasks.push_back(move(task));
+    }
+    wake.notify_one();
+}
+
+// Own work is taken from the back: the newest, smallest, cache-warm piece
+bool ThreadPool::popLocal(size_t q, function<void()>& task) {
+    lock_guard<mutex> guard(queues[q]->lock);
+    if (queues[q]->tasks.empty()) {
+        return false;
+    }
+    task = move(queues[q]->tasks.back());
+    queues[q]->tasks.pop_back();
+    return true;
+}
+
+// Stolen work is taken from the front: the oldest, largest piece
+bool ThreadPool::steal(size_t thief, function<void()>& task) {
+    for (size_t k = 1; k <= queues.size(); k++) {
+        Queue& victim = *queues[(thief + k) % queues.size()];
+        lock_guard<mutex> guard(victim.lock);
+        if (!victim.tasks.empty()) {
+            task = move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::runPending() {
+    function<void()> task;
+    size_t self = workerIndex >= 0 ? (size_t)workerIndex : 0;
+    if ((workerIndex >= 0 && popLocal(self, task)) || steal(self, task)) {
+        queued--;
+        task();
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::workerLoop(size_t index) {
+    workerIndex = (int)index;
+    while (true) {
+        if (runPending()) {
+            continue;
+        }
+        unique_lock<mutex> guard(sleepLock);
+        wake.wait(guard, [this] { return stopping || queued > 0; });
+        if (stopping && queued == 0) {
+            return;
+        }
+    }
+}
+
+/*
+ * Function: parallelChunks
+ * Purpose: Calls body(chunk, begin, end) for every chunk of [0, n)
+ * The whole range starts as one task. A task holding more than one chunk
+ * hands the upper half back to the pool and keeps the lower half, so the
+ * range is split only as far as idle workers actually need. The calling
+ * thread helps run tasks until every chunk is done.
+ */
+void parallelChunks(ThreadPool& pool, size_t n, size_t chunkSize,
+                    const function<void(size_t, size_t, size_t)>& body) {
+    size_t chunks = (n + chunkSize - 1) / chunkSize;
+    atomic<size_t> remaining(chunks);
+
+    function<void(size_t, size_t)> run = [&](size_t first, size_t last) {
+        while (last - first > 1) {
+            size_t mid = first + (last - first) / 2;
+            pool.submit([&run, mid, last] { run(mid, last); });
+            last = mid;
+        }
+        size_t begin = first * chunkSize;
+        body(first, begin, min(n, begin + chunkSize));
+        remaining--;
+    };
+
+    if (chunks > 0) {
+        pool.submit([&run, chunks] { run(0, chunks); });
+    }
+    while (remaining > 0) {
+        if (!pool.runPending()) {
+            this_thread::yield();
+        }
+    }
+}
+
+// Chunks of about 64 KB of Car objects: small enough to stay in L2
+const size_t CHUNK_CARS = 65536 / sizeof(Car);
+
+/*
+ * Function: parallelCount
+ * Purpose: Counts the cars for which pred(car) is true
+ */
+template <typename Pred>
+size_t parallelCount(ThreadPool& pool, const vector<Car>& cars, Pred pred) {
+    atomic<size_t> total(0);
+    parallelChunks(pool, cars.size(), CHUNK_CARS, [&](size_t, size_t begin, size_t end) {
+        size_t local = 0;
+        for (size_t i = begin; i < end; i++) {
+            local += pred(cars[i]) ? 1 : 0;
+        }
+        total += local;
+    });
+    return total;
+}
+
+/*
+ * Function: parallelFilter
+ * Purpose: Returns the ids of matching cars, in their original order
+ * Each chunk writes into its own vector, then the pieces are joined.
+ */
+template <typename Pred>
+vector<size_t> parallelFilter(ThreadPool& pool, const vector<Car>& cars, Pred pred) {
+    vector<vector<size_t>> pieces((cars.size() + CHUNK_CARS - 1) / CHUNK_CARS);
+    parallelChunks(pool, cars.size(), CHUNK_CARS, [&](size_t chunk, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            if (pred(cars[i])) {
+                pieces[chunk].push_back(i);
+            }
+        }
+    });
+    vector<size_t> ids;
+    for (const vector<size_t>& piece : pieces) {
+        ids.insert(ids.end(), piece.begin(), piece.end());
+    }
+    return ids;
+}
+
+/*
+ * Function: parallelMapReduce
+ * Purpose: Folds every car into a per-chunk result with accumulate(acc, car),
+ * then combines the chunk results in order with combine(acc, part).
+ */
+template <typename R, typename Accumulate, typename Combine>
+R parallelMapReduce(ThreadPool& pool, const vector<Car>& cars, R init,
+                    Accumulate accumulate, Combine combine) {
+    vector<R> parts((cars.size() + CHUNK_CARS - 1) / CHUNK_CARS, init);
+    parallelChunks(pool, cars.size(), CHUNK_CARS, [&](size_t chunk, size_t begin, size_t end) {
+        R local = init;
+        for (size_t i = begin; i < end; i++) {
+            accumulate(local, cars[i]);
+        }
+        parts[chunk] = local;
+    });
+    R result = init;
+    for (const R& part : parts) {
+        combine(result, part);
+    }
+    return result;
+}
+
+const int FIRST_YEAR = 1960;
+const int YEARS = 66;  // 1960..2025
+
+// Adds a car to a count-by-year histogram; years outside the table are skipped
+void countYear(vector<size_t>& hist, const Car& car) {
+    int bucket = car.getYear() - FIRST_YEAR;
+    if (bucket >= 0 && bucket < YEARS) {
+        hist[bucket]++;
+    }
+}
+
+// Count-by-year on the calling thread alone: the baseline for speedups
+vector<size_t> countByYearSequential(const vector<Car>& cars) {
+    vector<size_t> hist(YEARS, 0);
+    for (const Car& car : cars) {
+        countYear(hist, car);
+    }
+    return hist;
+}
+
+// Count-by-year: a histogram with one bucket per model year
+vector<size_t> countByYear(ThreadPool& pool, const vector<Car>& cars) {
+    return parallelMapReduce(pool, cars, vector<size_t>(YEARS, 0), countYear,
+        [](vector<size_t>& hist, const vector<size_t>& part) {
+            for (int y = 0; y < YEARS; y++) {
+                hist[y] += part[y];
+            }
+        });
+}
+
+/*
+ * Function: benchmark
+ * Purpose: Times count-by-year with a growing number of pool workers and
+ * reports the speedup over a plain sequential loop. The calling thread
+ * also runs tasks while it waits, so a pool of N workers uses N + 1
+ * threads.
+ */
+void benchmark(size_t count, size_t maxThreads) {
+    const string brands[] = {"Ford", "BMW", "Chevrolet", "Range Rover", "Volvo", "Ferrari"};
+    const string models[] = {"Mustang", "M5", "Camaro", "Sport", "XC90", "488"};
+    vector<Car> cars;
+    cars.reserve(count);
+    unsigned seed = 12345;
+    for (size_t i = 0; i < count; i++) {
+        seed = seed * 1103515245u + 12345u;
+        cars.push_back(Car(brands[(seed >> 8) % 6], models[(seed >> 12) % 6],
+                           FIRST_YEAR + (int)((seed >> 16) % YEARS)));
+    }
+
+    cout << "Count-by-year over " << count << " cars ("
+         << thread::hardware_concurrency() << " hardware threads)" << endl;
+
+    double single = 1e30;
+    vector<size_t> reference;
+    for (int r = 0; r < 5; r++) {
+        auto start = chrono::steady_clock::now();
+        reference = countByYearSequential(cars);
+        single = min(single, chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+    }
+    cout << "  sequential loop: " << single << " ms" << endl;
+    for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+        ThreadPool pool(threads);
+        double best = 1e30;
+        vector<size_t> hist;
+        for (int r = 0; r < 5; r++) {
+            auto start = chrono::steady_clock::now();
+            hist = countByYear(pool, cars);
+            best = min(best, chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+        }
+        cout << "  " << threads << " workers + caller: " << best << " ms, speedup "
+             << single / best << "x" << (hist == reference ? "" : "  MISMATCH!") << endl;
+    }
+    cout << endl;
+}
+
+int main(int argc, char* argv[]) {
+
+    vector<Car> cars;
+    cars.push_back(Car("Ford", "Mustang", 2013));
+    cars.push_back(Car("BMW", "M5", 2020));
+    cars.push_back(Car("Chevrolet", "Camaro", 2021));
+    cars.push_back(Car("BMW", "X5", 2024));
+    cars.push_back(Car("Ford", "Model T", 1925));  // Older than the year table
+
+    ThreadPool pool(4);
+
+    size_t bmws = parallelCount(pool, cars, [](const Car& c) { return c.getBrand() == "BMW"; });
+    cout << "BMWs: " << bmws << endl;
+
+    vector<size_t> recent = parallelFilter(pool, cars, [](const Car& c) {
+        return c.getYear() >= 2013 && c.getYear() <= 2021;
+    });
+    cout << "Cars from 2013-2021:" << endl;
+    for (size_t id : recent) {
+        cout << "  " << cars[id].getBrand() << " " << cars[id].getModel() << endl;
+    }
+
+    int newest = parallelMapReduce(pool, cars, 0,
+        [](int& best, const Car& c) { best = max(best, c.getYear()); },
+        [](int& best, int part) { best = max(best, part); });
+    cout << "Newest model year: " << newest << endl;
+
+    vector<size_t> byYear = countByYear(pool, cars);
+    size_t inTable = 0;
+    for (size_t n : byYear) inTable += n;
+    cout << "Cars in the " << FIRST_YEAR << "-" << FIRST_YEAR + YEARS - 1 << " histogram: " << inTable << " of "
+         << cars.size() << endl << endl;
+
+    size_t count = 4000000;
+    size_t maxThreads = 16;
+    if (argc > 1) {
+        count = strtoul(argv[1], nullptr, 10);
+    }
+    if (argc > 2) {
+        maxThreads = strtoul(argv[2], nullptr, 10);
+    }
+    benchmark(count, maxThreads);
+
+    /*
+     * Key Learning Points:
+     * 1. One deque per worker avoids a single hot lock for all threads
+     * 2. Owners pop from the back (LIFO), thieves steal from the front (FIFO)
+     * 3. Splitting ranges lazily means small inputs are not over-split
+     * 4. Per-chunk partial results avoid sharing counters between threads
+     * 5. Scaling stops once the loop is limited by memory bandwidth
+     */
+
+    return 0;
+}
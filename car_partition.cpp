@@ -0,0 +1,231 @@
+/*
+ * C++ Type-Partitioned Container Examples
+ * =======================================
+ *
+ * This file demonstrates storing a class hierarchy without pointers:
+ * - Car and SportsCar from protected_access_specifier.cpp, with virtual
+ *   print() and summary() so they can be mixed in one collection
+ * - The usual way: vector<unique_ptr<Car>> (one heap object per car)
+ * - PartitionedFleet<Car, SportsCar>: one contiguous vector per type
+ * - forEach() calls the visitor once per partition with the exact type
+ *
+ * Concept: In vector<unique_ptr<Car>> every element is a pointer to a
+ * separate allocation, and every call goes through the vtable because the
+ * compiler cannot know the real type. If all SportsCars live together in a
+ * vector<SportsCar>, the loop over that vector knows the type, so calls
+ * are direct (and can be inlined) and memory is read sequentially.
+ *
+ * Usage: ./partition [cars]   (default: 5000000)
+ */
+
+#include <algorithm>    // For shuffle
+#include <chrono>       // For timing the benchmark
+#include <cstdlib>      // For strtoul
+#include <iostream>     // For input/output operations
+#include <memory>       // For unique_ptr
+#include <random>       // For shuffling the pointer baseline
+#include <string>       // For string class
+#include <tuple>        // For holding one vector per type
+#include <type_traits>  // For decay_t / is_same
+#include <vector>       // For partitions
+using namespace std;
+
+class Car {
+    protected:
+        string brand;
+        string model;
+        int year;
+
+    public:
+        Car(string x, string y, int z) : brand(x), model(y), year(z) {}
+        virtual ~Car() {}
+
+        virtual void print() const {
+            cout << "    Car:        " << brand << " " << model << " (" << year << ")" << endl;
+        }
+
+        // A small per-car computation standing in for real report logic
+        virtual long summary() const {
+            return year + (long)brand.size();
+        }
+
+        int getYear() const { return year; }
+};
+
+class SportsCar final : public Car {
+    private:
+        int topSpeed;
+
+    public:
+        SportsCar(string x, string y, int z, int speed) : Car(x, y, z), topSpeed(speed) {}
+
+        void print() const override {
+            cout << "    Sports Car: " << brand << " " << model << " (" << year
+                 << ", " << topSpeed << " km/h)" << endl;
+        }
+
+        long summary() const override {
+            return year + (long)brand.size() + topSpeed;
+        }
+};
+
+/*
+ * Class: PartitionedFleet
+ * Purpose: Stores each listed type in its own vector
+ * Types... is the closed set of concrete classes the fleet can hold.
+ * add() picks the partition from the argument's static type at compile
+ * time, so there is no tag to store and nothing to look up at run time.
+ */
+template <typename... Types>
+class PartitionedFleet {
+    private:
+        tuple<vector<Types>...> partitions;
+
+        template <size_t I, typename Visitor>
+        void visitFrom(Visitor& visit) const {
+            if constexpr (I < sizeof...(Types)) {
+                for (const auto& car : get<I>(partitions)) {
+                    visit(car);
+                }
+                visitFrom<I + 1>(visit);
+            }
+        }
+
+    public:
+        template <typename T>
+        void add(T car) {
+            get<vector<T>>(partitions).push_back(move(car));
+        }
+
+        template <typename T>
+        const vector<T>& partition() const {
+            return get<vector<T>>(partitions);
+        }
+
+        size_t size() const {
+            return apply([](const auto&... parts) { return (parts.size() + ... + 0); }, partitions);
+        }
+
+        /*
+         * Function: forEach
+         * Purpose: Calls visit(car) for every car, one partition at a time
+         * Inside each loop 'car' has its exact type, e.g. const SportsCar&.
+         */
+        template <typename Visitor>
+        void forEach(Visitor visit) const {
+            visitFrom<0>(visit);
+        }
+};
+
+/*
+ * Function: exactSummary
+ * Purpose: Calls T's own summary() directly, skipping the vtable
+ * Writing car.T::summary() names the exact function, which is safe here
+ * because a partition only ever holds objects of exactly type T.
+ */
+template <typename T>
+long exactSummary(const T& car) {
+    return car.T::summary();
+}
+
+double millisSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+/*
+ * Function: benchmark
+ * Purpose: Sums summary() over the same cars stored both ways
+ * The pointer vector is shuffled, as it would be after a service has run
+ * for a while and the cars came from many places.
+ */
+void benchmark(size_t count) {
+    vector<unique_ptr<Car>> pointers;
+    PartitionedFleet<Car, SportsCar> fleet;
+    pointers.reserve(count);
+
+    for (size_t i = 0; i < count; i++) {
+        int year = 1960 + (int)(i % 66);
+        if (i % 10 < 3) {
+            pointers.emplace_back(new SportsCar("Ferrari", "488", year, 300 + (int)(i % 40)));
+            fleet.add(SportsCar("Ferrari", "488", year, 300 + (int)(i % 40)));
+        } else {
+            pointers.emplace_back(new Car("Ford", "Mustang", year));
+            fleet.add(Car("Ford", "Mustang", year));
+        }
+    }
+    shuffle(pointers.begin(), pointers.end(), mt19937(3));
+
+    const int runs = 5;
+    double pointerMs = 1e30;
+    double partitionMs = 1e30;
+    long pointerTotal = 0;
+    long partitionTotal = 0;
+
+    for (int r = 0; r < runs; r++) {
+        auto start = chrono::steady_clock::now();
+        long total = 0;
+        for (const unique_ptr<Car>& car : pointers) {
+            total += car->summary();  // Virtual call through a pointer
+        }
+        pointerMs = min(pointerMs, millisSince(start));
+        pointerTotal = total;
+
+        start = chrono::steady_clock::now();
+        total = 0;
+        fleet.forEach([&total](const auto& car) {
+            total += exactSummary(car);  // Direct call on a known type
+        });
+        partitionMs = min(partitionMs, millisSince(start));
+        partitionTotal = total;
+    }
+
+    cout << "Summary over " << count << " cars (30% sports cars):" << endl;
+    cout << "  vector<unique_ptr<Car>>: " << pointerMs << " ms" << endl;
+    cout << "  PartitionedFleet:        " << partitionMs << " ms" << endl;
+    cout << "  Speedup:                 " << pointerMs / partitionMs << "x" << endl;
+    if (pointerTotal != partitionTotal) {
+        cout << "  MISMATCH between layouts!" << endl;
+    }
+    cout << endl;
+}
+
+int main(int argc, char* argv[]) {
+
+    PartitionedFleet<Car, SportsCar> fleet;
+    fleet.add(Car("Ford", "Mustang", 2013));
+    fleet.add(Car("BMW", "M5", 2020));
+    fleet.add(SportsCar("Ferrari", "488", 2022, 330));
+    fleet.add(SportsCar("Porsche", "911 GT3", 2023, 318));
+
+    cout << "Fleet of " << fleet.size() << " cars, "
+         << fleet.partition<SportsCar>().size() << " of them sports cars:" << endl;
+    fleet.forEach([](const auto& car) { car.print(); });
+
+    // A visitor can also treat partitions differently by their type
+    long sportsYears = 0;
+    fleet.forEach([&sportsYears](const auto& car) {
+        if constexpr (is_same<decay_t<decltype(car)>, SportsCar>::value) {
+            sportsYears += car.getYear();
+        }
+    });
+    cout << "Sum of sports car years: " << sportsYears << endl << endl;
+
+    size_t count = 5000000;
+    if (argc > 1) {
+        count = strtoul(argv[1], nullptr, 10);
+    }
+    benchmark(count);
+
+    /*
+     * Key Learning Points:
+     * 1. vector<unique_ptr<Base>> means one allocation and one pointer
+     *    chase per element, plus a virtual call the compiler cannot inline
+     * 2. Storing each concrete type in its own vector keeps objects packed
+     * 3. A generic lambda (auto parameter) is compiled once per type, so
+     *    each partition loop knows exactly what it is working with
+     * 4. 'final' and qualified calls (car.T::summary()) avoid the vtable
+     * 5. The trade-off: the set of types must be known at compile time
+     */
+
+    return 0;
+}
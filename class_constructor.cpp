@@ -2,6 +2,11 @@
 #include <string>
 using namespace std;
 
+// Probe for trace_examples.cpp; it does nothing unless trace.h is included first
+#ifndef TRACE_SCOPE
+#define TRACE_SCOPE(name) static_assert(true, "")
+#endif
+
 class Car {
     public:
         string brand;
@@ -19,6 +24,7 @@ Car::Car(string x, string y, int z) {
 }
 
 void Car::print() {
+    TRACE_SCOPE("Car::print");
     cout << "====================" << endl;
     cout << "Car Details: " << endl;
     cout << "Brand:  " << brand << endl;
@@ -0,0 +1,319 @@
+/*
+ * C++ Compile-Time Enum Reflection Examples
+ * =========================================
+ *
+ * rgbToString() in RGB.cpp builds a new std::string on every call, and
+ * the Level enum in enums.cpp (LOW = 25, MID = 50, HIGH = 75) cannot be
+ * printed or parsed by name at all. This file demonstrates EnumInfo<E>,
+ * which the compiler fills in from the enum itself:
+ * - enumName(value): the enumerator's name as a string_view; a table
+ *   lookup, no switch and no allocation
+ * - enumFromName("GREEN"): reverse lookup through a perfect hash that is
+ *   found at compile time (one hash, one compare)
+ * - EnumInfo<E>::VALUES / NAMES: iterate over all enumerators
+ * - A benchmark against the switch-and-string approach
+ *
+ * Concept: Inside a template, GCC and Clang spell out the template
+ * arguments in __PRETTY_FUNCTION__, e.g. "[with E = RGB; E V = RED]",
+ * and for a value that is not an enumerator they write "(RGB)3" instead.
+ * Instantiating the template for every value in a range (0..127 here)
+ * and cutting the names out of these strings in constexpr code gives a
+ * complete name table at compile time. Enums should have a fixed
+ * underlying type (enum RGB : int), so every value in the range is legal.
+ *
+ * Usage: ./enumreflect [calls]   (default: 50000000)
+ */
+
+#include <array>          // For compile-time tables
+#include <chrono>         // For timing the benchmark
+#include <cstdint>        // For uint32_t
+#include <cstdlib>        // For strtoul
+#include <iostream>       // For input/output operations
+#include <optional>       // For failed lookups
+#include <string>         // For the switch-and-string baseline
+#include <string_view>    // For names without allocation
+#include <unordered_map>  // For the map baseline
+#include <utility>        // For index_sequence
+using namespace std;
+
+// RGB from RGB.cpp and Level from enums.cpp, with a fixed underlying type
+enum RGB : int {
+    RED,    // 0
+    GREEN,  // 1
+    BLUE    // 2
+};
+
+enum Level : int {
+    LOW = 25,
+    MID = 50,
+    HIGH = 75
+};
+
+/*
+ * Function: enumeratorName
+ * Purpose: The name of enumerator V, or an empty view if V is not one
+ * "Level::LOW" and "ns::RED" are cut down to "LOW" and "RED".
+ */
+template <typename E, E V>
+constexpr string_view enumeratorName() {
+    string_view text = __PRETTY_FUNCTION__;
+    size_t start = text.find("V = ");
+    if (start == string_view::npos) {
+        return {};
+    }
+    start += 4;
+    size_t end = text.find_first_of(";]", start);
+    string_view name = text.substr(start, end - start);
+    if (name.empty() || name[0] == '(' || name[0] == '-' || (name[0] >= '0' && name[0] <= '9')) {
+        return {};  // Printed as a cast or a number: not an enumerator
+    }
+    size_t colon = name.rfind("::");
+    return colon == string_view::npos ? name : name.substr(colon + 2);
+}
+
+/*
+ * Class: EnumInfo
+ * Purpose: Compile-time metadata for enum E with values in [Min, Max]
+ * Everything here is constexpr: the tables exist before main() runs.
+ */
+template <typename E, int Min = 0, int Max = 127>
+struct EnumInfo {
+    static constexpr int MIN = Min;
+    static constexpr size_t RANGE = Max - Min + 1;
+
+    template <size_t... I>
+    static constexpr array<string_view, RANGE> namesInRange(index_sequence<I...>) {
+        return {{enumeratorName<E, (E)(Min + (int)I)>()...}};
+    }
+
+    // Name of every value in the range, empty where there is no enumerator
+    static constexpr array<string_view, RANGE> BY_VALUE = namesInRange(make_index_sequence<RANGE>());
+
+    static constexpr size_t countEnumerators() {
+        size_t count = 0;
+        for (string_view name : BY_VALUE) count += !name.empty();
+        return count;
+    }
+
+    static constexpr size_t COUNT = countEnumerators();
+
+    static constexpr array<E, COUNT> listValues() {
+        array<E, COUNT> values{};
+        for (size_t i = 0, out = 0; i < RANGE; i++) {
+            if (!BY_VALUE[i].empty()) values[out++] = (E)(Min + (int)i);
+        }
+        return values;
+    }
+
+    // All enumerators in increasing order, and their names
+    static constexpr array<E, COUNT> VALUES = listValues();
+
+    static constexpr array<string_view, COUNT> listNames() {
+        array<string_view, COUNT> names{};
+        for (size_t i = 0; i < COUNT; i++) names[i] = BY_VALUE[VALUES[i] - Min];
+        return names;
+    }
+
+    static constexpr array<string_view, COUNT> NAMES = listNames();
+
+    // Perfect hash: a seed for which every name lands in its own slot.
+    // Like gperf, the quick hash only reads the length and three
+    // characters; if no seed separates the names that way, every
+    // character is hashed instead (FULL_HASH).
+    static constexpr size_t tableSize() {
+        size_t size = 1;
+        while (size < 2 * COUNT) size *= 2;
+        return size;
+    }
+
+    static constexpr size_t SLOTS = tableSize();
+
+    static constexpr uint32_t hash(string_view name, uint32_t seed, bool full) {
+        uint32_t h = (uint32_t)name.size() * 0x9E3779B1u ^ seed;
+        if (full) {
+            for (char c : name) h = (h ^ (unsigned char)c) * 16777619u;
+        } else if (!name.empty()) {
+            h ^= (unsigned char)name[0] | (unsigned char)name[name.size() / 2] << 8 |
+                 (unsigned char)name[name.size() - 1] << 16;
+        }
+        h *= 0x85EBCA6Bu;
+        return h ^ (h >> 16);
+    }
+
+    static constexpr uint32_t NO_SEED = UINT32_MAX;
+
+    static constexpr uint32_t findSeed(bool full) {
+        for (uint32_t seed = 0; seed < 100000; seed++) {
+            bool used[SLOTS] = {};
+            bool clash = false;
+            for (size_t i = 0; i < COUNT && !clash; i++) {
+                size_t slot = hash(NAMES[i], seed, full) & (SLOTS - 1);
+                clash = used[slot];
+                used[slot] = true;
+            }
+            if (!clash) {
+                return seed;
+            }
+        }
+        return NO_SEED;
+    }
+
+    static constexpr bool FULL_HASH = findSeed(false) == NO_SEED;
+    static constexpr uint32_t SEED = findSeed(FULL_HASH);
+    static_assert(SEED != NO_SEED, "no perfect hash seed found");
+
+    static constexpr size_t slotOf(string_view name) {
+        return hash(name, SEED, FULL_HASH) & (SLOTS - 1);
+    }
+
+    static constexpr array<int, SLOTS> buildSlots() {
+        array<int, SLOTS> slots{};
+        for (int& s : slots) s = -1;
+        for (size_t i = 0; i < COUNT; i++) {
+            slots[slotOf(NAMES[i])] = (int)i;
+        }
+        return slots;
+    }
+
+    // Index into VALUES/NAMES for each hash slot, -1 if empty
+    static constexpr array<int, SLOTS> SLOT_TO_INDEX = buildSlots();
+};
+
+/*
+ * Function: enumName
+ * Purpose: Name of 'value', or "" if it is not an enumerator
+ */
+template <typename E>
+constexpr string_view enumName(E value) {
+    using Info = EnumInfo<E>;
+    int offset = (int)value - Info::MIN;
+    if (offset < 0 || offset >= (int)Info::RANGE) {
+        return {};
+    }
+    return Info::BY_VALUE[offset];
+}
+
+// Length first, then the bytes (__builtin_memcmp also works in constexpr)
+constexpr bool sameName(string_view a, string_view b) {
+    return a.size() == b.size() && __builtin_memcmp(a.data(), b.data(), a.size()) == 0;
+}
+
+/*
+ * Function: enumFromName
+ * Purpose: The enumerator called 'name' (exact, case-sensitive match)
+ */
+template <typename E>
+constexpr optional<E> enumFromName(string_view name) {
+    using Info = EnumInfo<E>;
+    int index = Info::SLOT_TO_INDEX[Info::slotOf(name)];
+    if (index < 0 || !sameName(Info::NAMES[index], name)) {
+        return nullopt;
+    }
+    return Info::VALUES[index];
+}
+
+static_assert(enumName(GREEN) == "GREEN", "names are known at compile time");
+static_assert(enumFromName<Level>("HIGH") == HIGH, "so is the reverse lookup");
+static_assert(EnumInfo<Level>::COUNT == 3, "Level has three enumerators");
+
+// rgbToString() from RGB.cpp: a new string on every call
+string rgbToString(RGB color) {
+    switch (color) {
+        case RED:
+            return "Red";
+        case GREEN:
+            return "Green";
+        case BLUE:
+            return "Blue";
+        default:
+            return "Unknown";
+    }
+}
+
+// The matching hand-written parser
+optional<RGB> rgbFromString(const string& name) {
+    if (name == "RED") return RED;
+    if (name == "GREEN") return GREEN;
+    if (name == "BLUE") return BLUE;
+    return nullopt;
+}
+
+template <typename F>
+double nsPerCall(size_t calls, F f) {
+    auto start = chrono::steady_clock::now();
+    size_t sink = 0;
+    for (size_t i = 0; i < calls; i++) {
+        sink += f(i);
+    }
+    double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / calls;
+    if (sink == 0) {
+        cout << "(unexpected empty result)" << endl;
+    }
+    return ns;
+}
+
+void benchmark(size_t calls) {
+    // Values come from memory, so the compiler cannot fold the lookups away
+    volatile int colours[3] = {RED, GREEN, BLUE};
+    const string names[3] = {"RED", "GREEN", "BLUE"};
+    const string_view views[3] = {"RED", "GREEN", "BLUE"};
+    unordered_map<string, RGB> byName = {{"RED", RED}, {"GREEN", GREEN}, {"BLUE", BLUE}};
+
+    cout << "Enum to name (ns per call):" << endl;
+    cout << "  switch + string:      "
+         << nsPerCall(calls, [&](size_t i) { return rgbToString((RGB)colours[i % 3]).size(); }) << endl;
+    cout << "  enumName:             "
+         << nsPerCall(calls, [&](size_t i) { return enumName((RGB)colours[i % 3]).size(); }) << endl;
+
+    cout << "Name to enum (ns per call):" << endl;
+    cout << "  if-chain on string:   "
+         << nsPerCall(calls, [&](size_t i) { return (size_t)*rgbFromString(names[i % 3]) + 1; }) << endl;
+    cout << "  enumFromName:         "
+         << nsPerCall(calls, [&](size_t i) { return (size_t)*enumFromName<RGB>(views[i % 3]) + 1; }) << endl;
+    cout << "  unordered_map:        "
+         << nsPerCall(calls, [&](size_t i) { return (size_t)byName.find(names[i % 3])->second + 1; }) << endl;
+}
+
+int main(int argc, char* argv[]) {
+
+    RGB color1 = RED;
+    RGB color2 = GREEN;
+    RGB color3 = BLUE;
+    cout << "The color is: " << enumName(color1) << endl;
+    cout << "The color is: " << enumName(color2) << endl;
+    cout << "The color is: " << enumName(color3) << endl;
+
+    cout << "All Level values:";
+    for (Level level : EnumInfo<Level>::VALUES) {
+        cout << " " << enumName(level) << "=" << level;
+    }
+    cout << endl;
+
+    for (string_view text : {"MID", "BLUE", "PURPLE"}) {
+        optional<Level> level = enumFromName<Level>(text);
+        optional<RGB> color = enumFromName<RGB>(text);
+        cout << "\"" << text << "\": ";
+        if (level) cout << "Level " << *level;
+        else if (color) cout << "RGB " << *color;
+        else cout << "not an enumerator";
+        cout << endl;
+    }
+    cout << "enumName((Level)30): \"" << enumName((Level)30) << "\"" << endl << endl;
+
+    size_t calls = 50000000;
+    if (argc > 1) {
+        calls = strtoul(argv[1], nullptr, 10);
+    }
+    benchmark(calls);
+
+    /*
+     * Key Learning Points:
+     * 1. Returning string_view to static text avoids an allocation per call
+     * 2. Templates and constexpr can compute lookup tables at compile time
+     * 3. __PRETTY_FUNCTION__ exposes enumerator names to constexpr code
+     * 4. A perfect hash needs one hash and one compare per lookup
+     * 5. static_assert checks the tables while compiling
+     */
+
+    return 0;
+}
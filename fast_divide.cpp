@@ -0,0 +1,418 @@
+/*
+ * C++ Fast Division by Runtime Constants
+ * ======================================
+ *
+ * div_assign and mod_assign in assignmnt.cpp divide by const A = 2, so the
+ * compiler turns x / A into a shift. When the divisor is only known while
+ * the program runs, every x / d is a real division instruction, which
+ * takes 20-90 cycles. This file shows the trick compilers use, done at
+ * run time:
+ * - Divider<T> precomputes a "magic" multiplier and shift for divisor d
+ * - x / d then becomes a multiply (keeping the high half) and a shift
+ * - Works for int32_t, uint32_t, int64_t and uint64_t
+ * - Batch divide/modulo over arrays, with AVX2 for the 32-bit types
+ * - A check against the / and % operators (exhaustive over all 2^32
+ *   numerators with "./fastdiv exhaustive") and a benchmark
+ *
+ * Concept: For m close to 2^(W+s) / d, (x * m) >> (W+s) equals x / d. The
+ * algorithm below (Granlund & Montgomery, as used by libdivide) picks m
+ * and s so that this is exact for every W-bit x. When m needs one bit
+ * more than fits, an extra add-and-halve step ("add marker") fixes it up.
+ *
+ * Usage: ./fastdiv [elements]   or   ./fastdiv exhaustive
+ */
+
+#include <chrono>       // For timing the benchmark
+#include <cstdint>      // For fixed-width integer types
+#include <cstdlib>      // For strtoul
+#include <cstring>      // For strcmp
+#include <iostream>     // For input/output operations
+#include <limits>       // For numeric_limits
+#include <random>       // For random checks
+#include <string>       // For string class
+#include <type_traits>  // For is_signed / make_unsigned
+#include <vector>       // For batches
+#include <immintrin.h>  // For AVX2 intrinsics
+using namespace std;
+
+// Double-width helper types: the product of two W-bit numbers
+template <typename T> struct Wider;
+template <> struct Wider<uint32_t> { typedef uint64_t type; };
+template <> struct Wider<int32_t> { typedef int64_t type; };
+template <> struct Wider<uint64_t> { typedef unsigned __int128 type; };
+template <> struct Wider<int64_t> { typedef __int128 type; };
+
+const uint8_t ADD_MARKER = 0x40;       // The fix-up step is needed
+const uint8_t NEGATIVE_DIVISOR = 0x80; // Signed only: negate the result
+
+/*
+ * Class: Divider
+ * Purpose: Divides by a fixed divisor d without a division instruction
+ * Construct it once (this does one real division) and reuse it. As with
+ * the / operator, d must not be 0, and for signed types the most negative
+ * value divided by -1 overflows.
+ */
+template <typename T>
+class Divider {
+    private:
+        typedef typename make_unsigned<T>::type U;
+        typedef typename Wider<T>::type Wide;
+        static const int W = sizeof(T) * 8;
+        static const uint8_t SHIFT_MASK = W - 1;
+
+        T d;
+        T magic;      // 0 means "d is a power of two", use shifts only
+        uint8_t more; // Shift amount plus the flags above
+
+        static int floorLog2(U x) {
+            return W - 1 - (W == 32 ? __builtin_clz((uint32_t)x) : __builtin_clzll((uint64_t)x));
+        }
+
+    public:
+        static T mulhi(T a, T b) { return (T)(((Wide)a * (Wide)b) >> W); }
+
+        explicit Divider(T divisor);
+
+        T divisor() const { return d; }
+        T getMagic() const { return magic; }
+        uint8_t getMore() const { return more; }
+
+        T divide(T n) const;
+        T modulo(T n) const { return (T)((U)n - (U)divide(n) * (U)d); }
+};
+
+template <typename T>
+Divider<T>::Divider(T divisor) : d(divisor), magic(0), more(0) {
+    typedef typename Wider<U>::type UWide;
+    U absD = is_signed<T>::value && d < 0 ? (U)0 - (U)d : (U)d;
+    int log2d = floorLog2(absD);
+
+    if ((absD & (absD - 1)) == 0) {
+        // Powers of two need no multiplier at all
+        more = (uint8_t)log2d;
+    } else {
+        // For unsigned we aim at 2^(W+log2d) / d, for signed one bit lower
+        int k = is_signed<T>::value ? log2d - 1 : log2d;
+        UWide numerator = (UWide)((U)1 << k) << W;
+        U m = (U)(numerator / absD);
+        U rem = (U)(numerator % absD);
+        U e = absD - rem;
+        if (e < ((U)1 << log2d)) {
+            // This multiplier is already precise enough
+            more = (uint8_t)k;
+        } else {
+            // Use a multiplier one bit longer; divide() adds the fix-up
+            m += m;
+            U twiceRem = rem + rem;
+            if (twiceRem >= absD || twiceRem < rem) {
+                m += 1;
+            }
+            more = (uint8_t)(log2d | ADD_MARKER);
+        }
+        m += 1;
+        magic = (is_signed<T>::value && d < 0) ? (T)((U)0 - m) : (T)m;
+    }
+    if (is_signed<T>::value && d < 0) {
+        more |= NEGATIVE_DIVISOR;
+    }
+}
+
+/*
+ * Function: Divider::divide
+ * Purpose: Returns n / d (rounded toward zero, exactly like the operator)
+ */
+template <typename T>
+T Divider<T>::divide(T n) const {
+    int shift = more & SHIFT_MASK;
+    if (!is_signed<T>::value) {
+        if (magic == 0) {
+            return n >> shift;
+        }
+        U q = (U)mulhi(magic, n);
+        if (more & ADD_MARKER) {
+            U t = (((U)n - q) >> 1) + q;
+            return (T)(t >> shift);
+        }
+        return (T)(q >> shift);
+    }
+
+    // Signed: 'sign' is all ones for a negative divisor, else zero
+    U sign = (more & NEGATIVE_DIVISOR) ? ~(U)0 : 0;
+    if (magic == 0) {
+        // Round toward zero: add d-1 to negative n before shifting
+        U mask = ((U)1 << shift) - 1;
+        U uq = (U)n + ((U)(n >> (W - 1)) & mask);
+        T q = (T)uq >> shift;
+        return (T)(((U)q ^ sign) - sign);
+    }
+    U uq = (U)mulhi(magic, n);
+    if (more & ADD_MARKER) {
+        uq += ((U)n ^ sign) - sign;
+    }
+    T q = (T)uq >> shift;
+    return (T)((U)q + (q < 0 ? 1 : 0));
+}
+
+// ---------------------------------------------------------------------
+// Batch API
+// ---------------------------------------------------------------------
+
+bool cpuHasAVX2() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+const bool HAS_AVX2 = cpuHasAVX2();
+
+// High 32 bits of eight 32x32-bit products. mul_epu32/mul_epi32 only use
+// the even lanes, so the odd lanes are shifted down and done separately.
+__attribute__((target("avx2")))
+inline __m256i mulhiEpu32(__m256i a, __m256i m) {
+    __m256i even = _mm256_srli_epi64(_mm256_mul_epu32(a, m), 32);
+    __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), m);
+    return _mm256_blend_epi32(even, odd, 0xAA);
+}
+
+__attribute__((target("avx2")))
+inline __m256i mulhiEpi32(__m256i a, __m256i m) {
+    __m256i even = _mm256_srli_epi64(_mm256_mul_epi32(a, m), 32);
+    __m256i odd = _mm256_mul_epi32(_mm256_srli_epi64(a, 32), m);
+    return _mm256_blend_epi32(even, odd, 0xAA);
+}
+
+// Eight unsigned 32-bit quotients at once: the same steps as divide()
+__attribute__((target("avx2")))
+inline __m256i divideAVX2(const Divider<uint32_t>& div, __m256i n) {
+    uint8_t more = div.getMore();
+    __m128i shift = _mm_cvtsi32_si128(more & 31);
+    if (div.getMagic() == 0) {
+        return _mm256_srl_epi32(n, shift);
+    }
+    __m256i q = mulhiEpu32(n, _mm256_set1_epi32((int)div.getMagic()));
+    if (more & ADD_MARKER) {
+        __m256i t = _mm256_add_epi32(_mm256_srli_epi32(_mm256_sub_epi32(n, q), 1), q);
+        return _mm256_srl_epi32(t, shift);
+    }
+    return _mm256_srl_epi32(q, shift);
+}
+
+// Eight signed 32-bit quotients at once
+__attribute__((target("avx2")))
+inline __m256i divideAVX2(const Divider<int32_t>& div, __m256i n) {
+    uint8_t more = div.getMore();
+    int s = more & 31;
+    __m128i shift = _mm_cvtsi32_si128(s);
+    __m256i sign = _mm256_set1_epi32((more & NEGATIVE_DIVISOR) ? -1 : 0);
+    __m256i q;
+    if (div.getMagic() == 0) {
+        __m256i mask = _mm256_set1_epi32((int)((1u << s) - 1));
+        q = _mm256_add_epi32(n, _mm256_and_si256(_mm256_srai_epi32(n, 31), mask));
+        q = _mm256_sra_epi32(q, shift);
+        return _mm256_sub_epi32(_mm256_xor_si256(q, sign), sign);
+    }
+    q = mulhiEpi32(n, _mm256_set1_epi32(div.getMagic()));
+    if (more & ADD_MARKER) {
+        q = _mm256_add_epi32(q, _mm256_sub_epi32(_mm256_xor_si256(n, sign), sign));
+    }
+    q = _mm256_sra_epi32(q, shift);
+    return _mm256_add_epi32(q, _mm256_srli_epi32(q, 31));
+}
+
+template <typename T>
+__attribute__((target("avx2")))
+void divideBatchAVX2(const Divider<T>& div, const T* in, T* quotient, T* remainder, size_t n) {
+    const __m256i d = _mm256_set1_epi32((int)div.divisor());
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)(in + i));
+        __m256i q = divideAVX2(div, x);
+        if (quotient != nullptr) {
+            _mm256_storeu_si256((__m256i*)(quotient + i), q);
+        }
+        if (remainder != nullptr) {
+            _mm256_storeu_si256((__m256i*)(remainder + i), _mm256_sub_epi32(x, _mm256_mullo_epi32(q, d)));
+        }
+    }
+    for (; i < n; i++) {
+        T q = div.divide(in[i]);
+        if (quotient != nullptr) quotient[i] = q;
+        if (remainder != nullptr) remainder[i] = (T)((uint32_t)in[i] - (uint32_t)q * (uint32_t)div.divisor());
+    }
+}
+
+/*
+ * Function: divideBatch
+ * Purpose: quotient[i] = in[i] / d and remainder[i] = in[i] % d
+ * Either output may be nullptr if it is not needed. 32-bit types use AVX2
+ * when available; 64-bit types use the scalar multiply (AVX2 has no
+ * 64x64-bit high multiply), which is still far cheaper than division.
+ */
+template <typename T>
+void divideBatch(const Divider<T>& div, const T* in, T* quotient, T* remainder, size_t n) {
+    if constexpr (sizeof(T) == 4) {
+        if (HAS_AVX2) {
+            divideBatchAVX2(div, in, quotient, remainder, n);
+            return;
+        }
+    }
+    for (size_t i = 0; i < n; i++) {
+        T q = div.divide(in[i]);
+        if (quotient != nullptr) quotient[i] = q;
+        if (remainder != nullptr) remainder[i] = (T)((typename make_unsigned<T>::type)in[i] -
+                                                     (typename make_unsigned<T>::type)q * div.divisor());
+    }
+}
+
+// ---------------------------------------------------------------------
+// Checks
+// ---------------------------------------------------------------------
+
+// True if n / d would overflow (most negative value divided by -1)
+template <typename T>
+bool overflows(T n, T d) {
+    return is_signed<T>::value && d == (T)-1 && n == numeric_limits<T>::min();
+}
+
+/*
+ * Function: checkRandom
+ * Purpose: Compares divide/modulo with / and % for many random and edge
+ * case divisors and numerators, through both the scalar and batch paths.
+ */
+template <typename T>
+bool checkRandom(const char* typeName, int divisors) {
+    mt19937_64 rng(11);
+    vector<T> edges = {1, 2, 3, 5, 7, 10, 641, numeric_limits<T>::max(),
+                       (T)(numeric_limits<T>::max() / 2 + 1), (T)(numeric_limits<T>::max() - 1)};
+    if (is_signed<T>::value) {
+        edges.push_back((T)-1);
+        edges.push_back((T)-7);
+        edges.push_back(numeric_limits<T>::min());
+        edges.push_back((T)(numeric_limits<T>::min() + 1));
+    }
+    vector<T> nums(4096);
+    vector<T> q(nums.size()), r(nums.size());
+    for (int k = 0; k < divisors; k++) {
+        T d = k < (int)edges.size() ? edges[k] : (T)(rng() >> (rng() % (sizeof(T) * 8)));
+        if (d == 0) continue;
+        Divider<T> div(d);
+        for (size_t i = 0; i < nums.size(); i++) {
+            nums[i] = i < edges.size() ? edges[i] : (T)(rng() >> (rng() % (sizeof(T) * 8)));
+            if (i % 2 && is_signed<T>::value) nums[i] = (T)((typename make_unsigned<T>::type)0 - nums[i]);
+            if (overflows(nums[i], d)) nums[i] = 0;
+        }
+        divideBatch(div, nums.data(), q.data(), r.data(), nums.size());
+        for (size_t i = 0; i < nums.size(); i++) {
+            T n = nums[i];
+            if (div.divide(n) != n / d || div.modulo(n) != n % d || q[i] != n / d || r[i] != n % d) {
+                cout << "  " << typeName << " FAILED: " << (long long)n << " / " << (long long)d << endl;
+                return false;
+            }
+        }
+    }
+    cout << "  " << typeName << ": " << divisors << " divisors x " << nums.size() << " numerators ok" << endl;
+    return true;
+}
+
+/*
+ * Function: checkExhaustive
+ * Purpose: Tries every one of the 2^32 numerators for a 32-bit type
+ */
+template <typename T>
+bool checkExhaustive(const char* typeName, T d) {
+    Divider<T> div(d);
+    const size_t block = 1 << 16;
+    vector<T> nums(block), q(block), r(block);
+    for (uint64_t base = 0; base < (1ull << 32); base += block) {
+        for (size_t i = 0; i < block; i++) {
+            nums[i] = (T)(uint32_t)(base + i);
+            if (overflows(nums[i], d)) nums[i] = 0;
+        }
+        divideBatch(div, nums.data(), q.data(), r.data(), block);
+        for (size_t i = 0; i < block; i++) {
+            if (q[i] != nums[i] / d || r[i] != nums[i] % d || div.divide(nums[i]) != q[i]) {
+                cout << "  " << typeName << " FAILED: " << (long long)nums[i] << " / " << (long long)d << endl;
+                return false;
+            }
+        }
+    }
+    cout << "  " << typeName << " / " << (long long)d << ": all 2^32 numerators ok" << endl;
+    return true;
+}
+
+// ---------------------------------------------------------------------
+// Benchmark
+// ---------------------------------------------------------------------
+
+template <typename T>
+void benchmark(const char* typeName, size_t n, T d) {
+    vector<T> in(n), q(n), r(n);
+    mt19937_64 rng(5);
+    for (T& x : in) x = (T)rng();
+
+    double plain = 1e30, fast = 1e30;
+    for (int rep = 0; rep < 3; rep++) {
+        auto t0 = chrono::steady_clock::now();
+        for (size_t i = 0; i < n; i++) {
+            q[i] = in[i] / d;
+            r[i] = in[i] % d;
+        }
+        plain = min(plain, chrono::duration<double, nano>(chrono::steady_clock::now() - t0).count());
+
+        Divider<T> div(d);
+        t0 = chrono::steady_clock::now();
+        divideBatch(div, in.data(), q.data(), r.data(), n);
+        fast = min(fast, chrono::duration<double, nano>(chrono::steady_clock::now() - t0).count());
+    }
+    cout << "  " << typeName << "\t" << plain / n << "\t\t" << fast / n
+         << "\t\t" << plain / fast << "x" << endl;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && strcmp(argv[1], "exhaustive") == 0) {
+        cout << "Exhaustive check over all 32-bit numerators:" << endl;
+        bool ok = true;
+        for (uint32_t d : {3u, 7u, 10u, 641u, 0x80000001u, 0xFFFFFFFFu}) {
+            ok &= checkExhaustive<uint32_t>("uint32", d);
+        }
+        for (int32_t d : {3, -3, 7, -7, 10, 641, -1, numeric_limits<int32_t>::min(), numeric_limits<int32_t>::max()}) {
+            ok &= checkExhaustive<int32_t>("int32", d);
+        }
+        return ok ? 0 : 1;
+    }
+
+    // The division from assignmnt.cpp, but with a divisor chosen at run time
+    // (volatile stops the compiler from treating it as a constant)
+    int x = 10;
+    volatile int runtimeA = 2;
+    Divider<int> byA(runtimeA);
+    cout << "Div Assign (x = x / A): " << byA.divide(x) << endl;
+    cout << "Mod Assign (x = x % A): " << byA.modulo(x) << endl << endl;
+
+    cout << "Random and edge-case checks against / and %:" << endl;
+    bool ok = checkRandom<uint32_t>("uint32", 2000) && checkRandom<int32_t>("int32", 2000) &&
+              checkRandom<uint64_t>("uint64", 2000) && checkRandom<int64_t>("int64", 2000);
+    cout << (ok ? "" : "CHECKS FAILED\n") << endl;
+
+    size_t n = 8000000;
+    if (argc > 1) {
+        n = strtoul(argv[1], nullptr, 10);
+    }
+    volatile int divisor = 7;
+    cout << "Quotient + remainder by a runtime divisor (" << divisor << "), ns/element:" << endl;
+    cout << "  type\t/ and %\t\tDivider\t\tspeedup" << endl;
+    benchmark<uint32_t>("uint32", n, (uint32_t)divisor);
+    benchmark<int32_t>("int32", n, (int32_t)divisor);
+    benchmark<uint64_t>("uint64", n, (uint64_t)divisor);
+    benchmark<int64_t>("int64", n, (int64_t)divisor);
+
+    /*
+     * Key Learning Points:
+     * 1. Division is one of the slowest integer instructions
+     * 2. Dividing by a constant can be replaced by multiply + shift
+     * 3. The magic numbers can be computed once at run time and reused
+     * 4. Signed division rounds toward zero, which needs a small fix-up
+     * 5. Exhaustive testing is possible (and worth it) for 32-bit inputs
+     */
+
+    return ok ? 0 : 1;
+}
@@ -17,6 +17,11 @@
 #include <iostream>  // For input/output operations
 using namespace std;
 
+// Probe for trace_examples.cpp; it does nothing unless trace.h is included first
+#ifndef TRACE_SCOPE
+#define TRACE_SCOPE(name) static_assert(true, "")
+#endif
+
 /*
  * Function: modifyStr
  * Purpose: Demonstrates string modification using pass-by-reference
@@ -63,6 +68,7 @@ void increOne(int &x) {
  * Algorithm: Swap characters from start and end, working towards middle
  */
 void reverseString(string &s) {
+    TRACE_SCOPE("reverseString");
     int len = s.length();  // Get string length
     
     // Loop through first half of string
@@ -0,0 +1,505 @@
+/*
+ * C++ Cache-Blocked and Morton-Order Grid Examples
+ * ================================================
+ *
+ * two_dim() and three_dim() in multidimenional.cpp loop over 2x2x2 arrays,
+ * which always fit in the cache. On large grids the order in which we
+ * visit elements decides the speed. This file demonstrates:
+ * - forEachTile(): visits a 2D index space tile by tile (cache blocking)
+ * - A blocked transpose compared with the naive one
+ * - MortonGrid2D/3D: storage in Z-order (Morton order), where elements
+ *   that are close in 2D/3D are also close in memory, in every direction
+ * - A benchmark of row, column and stencil access patterns that reports
+ *   time and, where the kernel allows it, cache misses (perf_event_open)
+ *
+ * Concept: The CPU loads memory in 64-byte lines. Reading a row-major grid
+ * along a row uses all 8 doubles of each line; reading it down a column
+ * uses one double per line, and by the time the next column needs the
+ * other 7 the line has been evicted. Tiling changes the visiting order so
+ * that a small block is finished while its lines are still cached.
+ * Morton order changes the layout instead: the bits of the row and column
+ * index are interleaved, so each 2x2, 4x4, 8x8 ... block is contiguous.
+ *
+ * Usage: ./blocking [2D size] [3D size]   (default: 4096 256, at least 3)
+ */
+
+#include <algorithm>      // For min/max
+#include <chrono>         // For timing the benchmark
+#include <cstdint>        // For uint64_t
+#include <cstdlib>        // For strtoul
+#include <cstring>        // For memset
+#include <iostream>       // For input/output operations
+#include <string>         // For string class
+#include <vector>         // For grid storage
+#include <linux/perf_event.h>  // For perf_event_attr
+#include <sys/ioctl.h>    // For enabling/disabling counters
+#include <sys/syscall.h>  // For SYS_perf_event_open
+#include <unistd.h>       // For syscall/read/close
+using namespace std;
+
+const size_t TILE = 64;  // 64 x 64 doubles = 32 KB, about one L1 data cache
+
+/*
+ * Function: forEachTile
+ * Purpose: Calls f(i, j) for every index of a rows x cols space, tile by
+ * tile; inside a tile, row by row. Any loop nest whose order does not
+ * matter can be turned into a cache-blocked one with it.
+ */
+template <typename F>
+void forEachTile(size_t rows, size_t cols, size_t tile, F f) {
+    for (size_t i0 = 0; i0 < rows; i0 += tile) {
+        size_t i1 = min(i0 + tile, rows);
+        for (size_t j0 = 0; j0 < cols; j0 += tile) {
+            size_t j1 = min(j0 + tile, cols);
+            for (size_t i = i0; i < i1; i++) {
+                for (size_t j = j0; j < j1; j++) {
+                    f(i, j);
+                }
+            }
+        }
+    }
+}
+
+// Transpose of a row-major n x n matrix, straight through
+void transposeNaive(const double* in, double* out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < n; j++) {
+            out[j * n + i] = in[i * n + j];
+        }
+    }
+}
+
+// The same, one tile at a time: the tile's source rows and destination
+// rows both stay in the cache until the tile is done
+void transposeBlocked(const double* in, double* out, size_t n, size_t tile = 32) {
+    forEachTile(n, n, tile, [in, out, n](size_t i, size_t j) {
+        out[j * n + i] = in[i * n + j];
+    });
+}
+
+// Spreads the low 32 bits of x to the even bit positions: abcd -> 0a0b0c0d
+uint64_t spreadBits2(uint64_t x) {
+    x &= 0xFFFFFFFF;
+    x = (x | (x << 16)) & 0x0000FFFF0000FFFFull;
+    x = (x | (x << 8)) & 0x00FF00FF00FF00FFull;
+    x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0Full;
+    x = (x | (x << 2)) & 0x3333333333333333ull;
+    x = (x | (x << 1)) & 0x5555555555555555ull;
+    return x;
+}
+
+// The reverse of spreadBits2: collects the even bits
+uint64_t compactBits2(uint64_t x) {
+    x &= 0x5555555555555555ull;
+    x = (x | (x >> 1)) & 0x3333333333333333ull;
+    x = (x | (x >> 2)) & 0x0F0F0F0F0F0F0F0Full;
+    x = (x | (x >> 4)) & 0x00FF00FF00FF00FFull;
+    x = (x | (x >> 8)) & 0x0000FFFF0000FFFFull;
+    x = (x | (x >> 16)) & 0x00000000FFFFFFFFull;
+    return x;
+}
+
+// Spreads the low 21 bits of x to every third bit: abc -> 00a00b00c
+uint64_t spreadBits3(uint64_t x) {
+    x &= 0x1FFFFF;
+    x = (x | (x << 32)) & 0x001F00000000FFFFull;
+    x = (x | (x << 16)) & 0x001F0000FF0000FFull;
+    x = (x | (x << 8)) & 0x100F00F00F00F00Full;
+    x = (x | (x << 4)) & 0x10C30C30C30C30C3ull;
+    x = (x | (x << 2)) & 0x1249249249249249ull;
+    return x;
+}
+
+uint64_t compactBits3(uint64_t x) {
+    x &= 0x1249249249249249ull;
+    x = (x | (x >> 2)) & 0x10C30C30C30C30C3ull;
+    x = (x | (x >> 4)) & 0x100F00F00F00F00Full;
+    x = (x | (x >> 8)) & 0x001F0000FF0000FFull;
+    x = (x | (x >> 16)) & 0x001F00000000FFFFull;
+    x = (x | (x >> 32)) & 0x00000000001FFFFFull;
+    return x;
+}
+
+// Bits of a 2D Morton index that hold the row (I) and column (J)
+const uint64_t MORTON2_I = 0xAAAAAAAAAAAAAAAAull;
+const uint64_t MORTON2_J = 0x5555555555555555ull;
+// Bits of a 3D Morton index that hold i, j and k
+const uint64_t MORTON3_I = 0x4924924924924924ull;
+const uint64_t MORTON3_J = 0x2492492492492492ull;
+const uint64_t MORTON3_K = 0x1249249249249249ull;
+
+/*
+ * Function: mortonNext / mortonPrev
+ * Purpose: Moves a Morton index one step along the dimension whose bits
+ * are in 'mask', without decoding it. Setting the other bits to 1 lets
+ * the +1 carry jump over them ("dilated integer" arithmetic).
+ */
+uint64_t mortonNext(uint64_t m, uint64_t mask) {
+    return (((m | ~mask) + 1) & mask) | (m & ~mask);
+}
+
+uint64_t mortonPrev(uint64_t m, uint64_t mask) {
+    return (((m & mask) - 1) & mask) | (m & ~mask);
+}
+
+size_t nextPowerOfTwo(size_t n) {
+    size_t p = 1;
+    while (p < n) p *= 2;
+    return p;
+}
+
+/*
+ * Class: MortonGrid2D
+ * Purpose: An n x n grid of doubles stored in Z-order
+ * The element at (i, j) lives at index interleave(i, j). Storage is
+ * rounded up to a power-of-two side, so odd sizes waste some memory.
+ */
+class MortonGrid2D {
+    private:
+        size_t side;
+        vector<double> cells;
+
+    public:
+        explicit MortonGrid2D(size_t n) : side(n), cells(nextPowerOfTwo(n) * nextPowerOfTwo(n)) {}
+
+        static uint64_t index(size_t i, size_t j) { return (spreadBits2(i) << 1) | spreadBits2(j); }
+        static void coordinates(uint64_t m, size_t& i, size_t& j) {
+            i = compactBits2(m >> 1);
+            j = compactBits2(m);
+        }
+
+        double& at(size_t i, size_t j) { return cells[index(i, j)]; }
+        double& atIndex(uint64_t m) { return cells[m]; }
+        size_t size() const { return side; }
+        size_t storedCells() const { return cells.size(); }
+};
+
+/*
+ * Class: MortonGrid3D
+ * Purpose: An n x n x n grid of doubles stored in 3D Z-order
+ */
+class MortonGrid3D {
+    private:
+        size_t side;
+        vector<double> cells;
+
+    public:
+        explicit MortonGrid3D(size_t n) : side(n), cells(nextPowerOfTwo(n) * nextPowerOfTwo(n) * nextPowerOfTwo(n)) {}
+
+        static uint64_t index(size_t i, size_t j, size_t k) {
+            return (spreadBits3(i) << 2) | (spreadBits3(j) << 1) | spreadBits3(k);
+        }
+        static void coordinates(uint64_t m, size_t& i, size_t& j, size_t& k) {
+            i = compactBits3(m >> 2);
+            j = compactBits3(m >> 1);
+            k = compactBits3(m);
+        }
+
+        double& at(size_t i, size_t j, size_t k) { return cells[index(i, j, k)]; }
+        double& atIndex(uint64_t m) { return cells[m]; }
+        size_t size() const { return side; }
+        size_t storedCells() const { return cells.size(); }
+};
+
+/*
+ * Class: CacheMissCounter
+ * Purpose: Counts L1 data cache and last-level cache misses of this
+ * thread with Linux perf_event_open. Containers and locked-down kernels
+ * (perf_event_paranoid) often refuse it; then available() is false and
+ * only times are reported.
+ */
+class CacheMissCounter {
+    private:
+        int l1 = -1;
+        int llc = -1;
+
+        static int openCounter(uint32_t type, uint64_t config) {
+            perf_event_attr attr;
+            memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = type;
+            attr.config = config;
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        }
+
+        static long long readCounter(int fd) {
+            long long value = 0;
+            if (fd < 0 || read(fd, &value, sizeof(value)) != sizeof(value)) {
+                return -1;
+            }
+            return value;
+        }
+
+    public:
+        long long l1Misses = -1;
+        long long llcMisses = -1;
+
+        CacheMissCounter() {
+            l1 = openCounter(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D |
+                             (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+            llc = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        }
+
+        ~CacheMissCounter() {
+            if (l1 >= 0) close(l1);
+            if (llc >= 0) close(llc);
+        }
+
+        CacheMissCounter(const CacheMissCounter&) = delete;
+        CacheMissCounter& operator=(const CacheMissCounter&) = delete;
+
+        bool available() const { return l1 >= 0 || llc >= 0; }
+
+        void start() {
+            for (int fd : {l1, llc}) {
+                if (fd >= 0) {
+                    ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                    ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+                }
+            }
+        }
+
+        void stop() {
+            for (int fd : {l1, llc}) {
+                if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            }
+            l1Misses = readCounter(l1);
+            llcMisses = readCounter(llc);
+        }
+};
+
+/*
+ * Function: measure
+ * Purpose: Runs 'work' three times and prints the best time plus the
+ * cache misses of the last run (in millions), under the given label
+ */
+template <typename Work>
+void measure(CacheMissCounter& counter, const string& label, Work work) {
+    double best = 1e30;
+    for (int run = 0; run < 3; run++) {
+        counter.start();
+        auto start = chrono::steady_clock::now();
+        work();
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        counter.stop();
+        best = min(best, ms);
+    }
+    cout << "    " << label << string(label.size() < 30 ? 30 - label.size() : 1, ' ') << best << " ms";
+    if (counter.l1Misses >= 0) cout << "\tL1 misses " << counter.l1Misses / 1e6 << "M";
+    if (counter.llcMisses >= 0) cout << "\tLLC misses " << counter.llcMisses / 1e6 << "M";
+    cout << endl;
+}
+
+void benchmark2D(CacheMissCounter& counter, size_t n) {
+    cout << "2D grid of " << n << " x " << n << " doubles (" << n * n * 8 / (1024 * 1024) << " MB):" << endl;
+    vector<double> grid(n * n);
+    vector<double> out(n * n);
+    MortonGrid2D morton(n);
+    MortonGrid2D mortonOut(n);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < n; j++) {
+            grid[i * n + j] = morton.at(i, j) = (double)((i * 31 + j * 17) % 97);
+        }
+    }
+    vector<double> sums(n);
+    bool same = true;  // Every method must give the same sums
+
+    cout << "  Row sums (each row visited left to right):" << endl;
+    measure(counter, "row-major", [&] {
+        for (size_t i = 0; i < n; i++) {
+            double s = 0;
+            for (size_t j = 0; j < n; j++) s += grid[i * n + j];
+            sums[i] = s;
+        }
+    });
+    double rowSum = sums[n / 2];
+    measure(counter, "Morton", [&] {
+        for (size_t i = 0; i < n; i++) {
+            double s = 0;
+            uint64_t m = MortonGrid2D::index(i, 0);
+            for (size_t j = 0; j < n; j++, m = mortonNext(m, MORTON2_J)) s += morton.atIndex(m);
+            sums[i] = s;
+        }
+    });
+    same = same && sums[n / 2] == rowSum;
+
+    cout << "  Column sums:" << endl;
+    measure(counter, "row-major, column by column", [&] {
+        for (size_t j = 0; j < n; j++) {
+            double s = 0;
+            for (size_t i = 0; i < n; i++) s += grid[i * n + j];
+            sums[j] = s;
+        }
+    });
+    double columnSum = sums[n / 2];
+    measure(counter, "row-major, tiled", [&] {
+        fill(sums.begin(), sums.end(), 0.0);
+        forEachTile(n, n, TILE, [&](size_t i, size_t j) { sums[j] += grid[i * n + j]; });
+    });
+    same = same && sums[n / 2] == columnSum;
+    measure(counter, "Morton, column by column", [&] {
+        for (size_t j = 0; j < n; j++) {
+            double s = 0;
+            uint64_t m = MortonGrid2D::index(0, j);
+            for (size_t i = 0; i < n; i++, m = mortonNext(m, MORTON2_I)) s += morton.atIndex(m);
+            sums[j] = s;
+        }
+    });
+    same = same && sums[n / 2] == columnSum;
+
+    cout << "  5-point stencil (average of the 4 neighbours):" << endl;
+    measure(counter, "row-major, row by row", [&] {
+        for (size_t i = 1; i + 1 < n; i++) {
+            for (size_t j = 1; j + 1 < n; j++) {
+                out[i * n + j] = 0.25 * (grid[(i - 1) * n + j] + grid[(i + 1) * n + j] +
+                                         grid[i * n + j - 1] + grid[i * n + j + 1]);
+            }
+        }
+    });
+    measure(counter, "row-major, column by column", [&] {
+        for (size_t j = 1; j + 1 < n; j++) {
+            for (size_t i = 1; i + 1 < n; i++) {
+                out[i * n + j] = 0.25 * (grid[(i - 1) * n + j] + grid[(i + 1) * n + j] +
+                                         grid[i * n + j - 1] + grid[i * n + j + 1]);
+            }
+        }
+    });
+    measure(counter, "row-major, tiled", [&] {
+        forEachTile(n - 2, n - 2, TILE, [&](size_t a, size_t b) {
+            size_t i = a + 1, j = b + 1;
+            out[i * n + j] = 0.25 * (grid[(i - 1) * n + j] + grid[(i + 1) * n + j] +
+                                     grid[i * n + j - 1] + grid[i * n + j + 1]);
+        });
+    });
+    measure(counter, "Morton, in storage order", [&] {
+        for (uint64_t m = 0; m < morton.storedCells(); m++) {
+            size_t i, j;
+            MortonGrid2D::coordinates(m, i, j);
+            if (i - 1 < n - 2 && j - 1 < n - 2) {  // 1 <= i, j <= n - 2
+                mortonOut.atIndex(m) = 0.25 * (morton.atIndex(mortonPrev(m, MORTON2_I)) +
+                                               morton.atIndex(mortonNext(m, MORTON2_I)) +
+                                               morton.atIndex(mortonPrev(m, MORTON2_J)) +
+                                               morton.atIndex(mortonNext(m, MORTON2_J)));
+            }
+        }
+    });
+
+    cout << "  Transpose:" << endl;
+    measure(counter, "naive", [&] { transposeNaive(grid.data(), out.data(), n); });
+    double corner = out[1];
+    measure(counter, "blocked (32 x 32 tiles)", [&] { transposeBlocked(grid.data(), out.data(), n); });
+
+    if (!same || corner != out[1] || out[1] != grid[n]) {
+        cout << "  MISMATCH between methods!" << endl;
+    }
+}
+
+void benchmark3D(CacheMissCounter& counter, size_t n) {
+    cout << "3D grid of " << n << " x " << n << " x " << n << " doubles ("
+         << n * n * n * 8 / (1024 * 1024) << " MB), 7-point stencil:" << endl;
+    vector<double> grid(n * n * n);
+    vector<double> out(n * n * n);
+    MortonGrid3D morton(n);
+    MortonGrid3D mortonOut(n);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < n; j++) {
+            for (size_t k = 0; k < n; k++) {
+                grid[(i * n + j) * n + k] = morton.at(i, j, k) = (double)((i * 7 + j * 5 + k * 3) % 97);
+            }
+        }
+    }
+    auto at = [&grid, n](size_t i, size_t j, size_t k) { return grid[(i * n + j) * n + k]; };
+    auto stencil = [&](size_t i, size_t j, size_t k) {
+        out[(i * n + j) * n + k] = (at(i - 1, j, k) + at(i + 1, j, k) + at(i, j - 1, k) + at(i, j + 1, k) +
+                                    at(i, j, k - 1) + at(i, j, k + 1)) / 6.0;
+    };
+
+    measure(counter, "row-major, k innermost", [&] {
+        for (size_t i = 1; i + 1 < n; i++)
+            for (size_t j = 1; j + 1 < n; j++)
+                for (size_t k = 1; k + 1 < n; k++) stencil(i, j, k);
+    });
+    measure(counter, "row-major, i innermost", [&] {
+        for (size_t k = 1; k + 1 < n; k++)
+            for (size_t j = 1; j + 1 < n; j++)
+                for (size_t i = 1; i + 1 < n; i++) stencil(i, j, k);
+    });
+    measure(counter, "row-major, tiled in i and j", [&] {
+        // Tiles of 16 x 16 columns of k: three planes' worth stay cached
+        forEachTile(n - 2, n - 2, 16, [&](size_t a, size_t b) {
+            for (size_t k = 1; k + 1 < n; k++) stencil(a + 1, b + 1, k);
+        });
+    });
+    double expected = out[(n / 2 * n + n / 2) * n + n / 2];
+    measure(counter, "Morton, in storage order", [&] {
+        for (uint64_t m = 0; m < morton.storedCells(); m++) {
+            size_t i, j, k;
+            MortonGrid3D::coordinates(m, i, j, k);
+            if (i - 1 < n - 2 && j - 1 < n - 2 && k - 1 < n - 2) {
+                mortonOut.atIndex(m) = (morton.atIndex(mortonPrev(m, MORTON3_I)) +
+                                        morton.atIndex(mortonNext(m, MORTON3_I)) +
+                                        morton.atIndex(mortonPrev(m, MORTON3_J)) +
+                                        morton.atIndex(mortonNext(m, MORTON3_J)) +
+                                        morton.atIndex(mortonPrev(m, MORTON3_K)) +
+                                        morton.atIndex(mortonNext(m, MORTON3_K))) / 6.0;
+            }
+        }
+    });
+    if (mortonOut.at(n / 2, n / 2, n / 2) != expected) {
+        cout << "  MISMATCH between methods!" << endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+
+    // two_dim() from multidimenional.cpp, visited in Z-order
+    string letters[2][2] = {
+        {"A", "B"},
+        {"C", "D"},
+    };
+    cout << "Z-order of a 2 x 2 grid: ";
+    for (uint64_t m = 0; m < 4; m++) {
+        size_t i, j;
+        MortonGrid2D::coordinates(m, i, j);
+        cout << letters[i][j] << " ";
+    }
+    cout << endl << "Morton index of (row, column) in a 4 x 4 grid:" << endl;
+    for (size_t i = 0; i < 4; i++) {
+        for (size_t j = 0; j < 4; j++) {
+            cout << MortonGrid2D::index(i, j) << "\t";
+        }
+        cout << "\n";
+    }
+    cout << endl;
+
+    size_t n2 = 4096;
+    size_t n3 = 256;
+    // The stencils need an interior: at least 3 cells along every side
+    if (argc > 1) {
+        n2 = max<size_t>(strtoul(argv[1], nullptr, 10), 3);
+    }
+    if (argc > 2) {
+        n3 = max<size_t>(strtoul(argv[2], nullptr, 10), 3);
+    }
+
+    CacheMissCounter counter;
+    if (!counter.available()) {
+        cout << "(perf_event_open is not available here: reporting times only)" << endl;
+    }
+    benchmark2D(counter, n2);
+    benchmark3D(counter, n3);
+
+    /*
+     * Key Learning Points:
+     * 1. Memory moves in 64-byte lines; use every byte of a line you load
+     * 2. Column-order access to a row-major grid wastes most of each line
+     * 3. Tiling finishes a small block while its lines are still cached
+     * 4. Morton order keeps neighbours close in every direction at once
+     * 5. Measure cache misses, not just time, to see why a loop is slow
+     */
+
+    return 0;
+}
@@ -0,0 +1,355 @@
+/*
+ * C++ Memoisation Examples
+ * ========================
+ *
+ * sum() in recursion.cpp calls itself once per step. Many recursive
+ * functions call themselves more than once, with arguments that overlap
+ * (fib(n) needs fib(n-1) and fib(n-2), and fib(n-1) needs fib(n-2) again),
+ * so the same values are computed over and over. This file demonstrates a
+ * reusable memoisation layer with three modes:
+ * - memoTable(): for small fixed domains, the whole table is computed by
+ *   the compiler (constexpr), so a lookup is one array read at runtime
+ * - LruMemo: a bounded cache that evicts the least recently used value,
+ *   for domains too large to keep everything
+ * - ConcurrentMemo: a thread-safe cache split into locked shards
+ * - Hit-rate statistics and a benchmark on binomial coefficients
+ *
+ * Concept: A recursive step is written once, taking 'self' as its first
+ * parameter and calling self(smaller argument) instead of itself. Whoever
+ * runs the step decides what self(...) does: recurse plainly, read a
+ * table, or look in a cache first. Only cache misses run the step.
+ *
+ * Usage: ./memo [queries]   (default: 2000)
+ */
+
+#include <array>          // For constexpr tables
+#include <atomic>         // For statistics shared between threads
+#include <chrono>         // For timing the benchmark
+#include <cstdint>        // For uint64_t
+#include <cstdlib>        // For strtoul
+#include <functional>     // For function/hash
+#include <iostream>       // For input/output operations
+#include <list>           // For LRU order
+#include <mutex>          // For unique_lock
+#include <random>         // For benchmark queries
+#include <shared_mutex>   // For reader/writer shard locks
+#include <thread>         // For the concurrent benchmark
+#include <unordered_map>  // For cache lookups
+#include <utility>        // For pair
+#include <vector>         // For query lists
+using namespace std;
+
+/*
+ * Struct: MemoStats
+ * Purpose: How well a cache worked. A hit is a call answered from the
+ * cache; a miss ran the step. Evictions are values dropped for space.
+ */
+struct MemoStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    size_t entries = 0;
+
+    double hitRate() const {
+        uint64_t calls = hits + misses;
+        return calls == 0 ? 0.0 : (double)hits / calls;
+    }
+};
+
+/*
+ * Class: PlainCall
+ * Purpose: Runs a step with no cache at all: self(arg) just recurses
+ */
+template <typename Arg, typename R>
+class PlainCall {
+    private:
+        R (*step)(PlainCall&, Arg);
+
+    public:
+        uint64_t calls = 0;
+
+        explicit PlainCall(R (*f)(PlainCall&, Arg)) : step(f) {}
+
+        R operator()(Arg arg) {
+            calls++;
+            return step(*this, arg);
+        }
+};
+
+// A compile-time table seen from inside a step: entries below the one
+// being computed are already filled in
+template <typename R>
+struct TableLookup {
+    const R* values;
+    constexpr R operator()(size_t i) const { return values[i]; }
+};
+
+/*
+ * Function: memoTable
+ * Purpose: Builds array<R, N> with table[i] = Step(lookup, i), bottom up
+ * Used in a constexpr variable, the compiler runs this and the program
+ * only contains the finished table. Step may only look up smaller i.
+ */
+template <typename R, size_t N, R (*Step)(TableLookup<R>&, size_t)>
+constexpr array<R, N> memoTable() {
+    array<R, N> table{};
+    TableLookup<R> lookup{table.data()};
+    for (size_t i = 0; i < N; i++) {
+        table[i] = Step(lookup, i);
+    }
+    return table;
+}
+
+/*
+ * Class: LruMemo
+ * Purpose: Memoises up to 'capacity' results, evicting the least
+ * recently used one when full
+ * The list keeps values from most to least recently used; the map finds a
+ * value's list position, so lookup, move-to-front and eviction are O(1).
+ * Not thread-safe.
+ */
+template <typename Arg, typename R>
+class LruMemo {
+    public:
+        using Step = function<R(LruMemo&, Arg)>;
+
+    private:
+        Step step;
+        size_t capacity;
+        list<pair<Arg, R>> order;
+        unordered_map<Arg, typename list<pair<Arg, R>>::iterator> index;
+        MemoStats counts;
+
+    public:
+        LruMemo(Step f, size_t maxEntries) : step(std::move(f)), capacity(maxEntries) {
+            index.reserve(maxEntries);
+        }
+
+        R operator()(Arg arg) {
+            auto found = index.find(arg);
+            if (found != index.end()) {
+                counts.hits++;
+                order.splice(order.begin(), order, found->second);
+                return found->second->second;
+            }
+            counts.misses++;
+            R value = step(*this, arg);  // May insert and evict other entries
+            if (capacity == 0) {
+                return value;
+            }
+            if (order.size() == capacity) {
+                index.erase(order.back().first);
+                order.pop_back();
+                counts.evictions++;
+            }
+            order.emplace_front(arg, value);
+            index.emplace(arg, order.begin());
+            return value;
+        }
+
+        MemoStats stats() const {
+            MemoStats result = counts;
+            result.entries = order.size();
+            return result;
+        }
+};
+
+/*
+ * Class: ConcurrentMemo
+ * Purpose: An unbounded memo table that many threads can share
+ * Keys are spread over SHARDS maps, each with its own reader/writer
+ * lock, so threads working on different keys rarely wait for each other.
+ * The step runs without any lock held (it recurses into the cache). Two
+ * threads missing the same key at the same time both compute it; the
+ * step must be a pure function, so both get the same value.
+ */
+template <typename Arg, typename R>
+class ConcurrentMemo {
+    public:
+        using Step = function<R(ConcurrentMemo&, Arg)>;
+
+    private:
+        static const size_t SHARDS = 32;
+
+        struct alignas(64) Shard {
+            shared_mutex lock;
+            unordered_map<Arg, R> values;
+            atomic<uint64_t> hits{0};
+            atomic<uint64_t> misses{0};
+        };
+
+        Step step;
+        Shard shards[SHARDS];
+
+        Shard& shardFor(const Arg& arg) {
+            // Mix the hash: for integers std::hash is the identity
+            uint64_t h = hash<Arg>()(arg) * 0x9E3779B97F4A7C15ull;
+            return shards[h >> 59];
+        }
+
+    public:
+        explicit ConcurrentMemo(Step f) : step(std::move(f)) {}
+
+        R operator()(Arg arg) {
+            Shard& shard = shardFor(arg);
+            {
+                shared_lock<shared_mutex> reading(shard.lock);
+                auto found = shard.values.find(arg);
+                if (found != shard.values.end()) {
+                    shard.hits.fetch_add(1, memory_order_relaxed);
+                    return found->second;
+                }
+            }
+            shard.misses.fetch_add(1, memory_order_relaxed);
+            R value = step(*this, arg);
+            unique_lock<shared_mutex> writing(shard.lock);
+            shard.values.emplace(arg, value);
+            return value;
+        }
+
+        MemoStats stats() {
+            MemoStats result;
+            for (Shard& shard : shards) {
+                shared_lock<shared_mutex> reading(shard.lock);
+                result.hits += shard.hits.load(memory_order_relaxed);
+                result.misses += shard.misses.load(memory_order_relaxed);
+                result.entries += shard.values.size();
+            }
+            return result;
+        }
+};
+
+// ---------------------------------------------------------------------
+// Recursive steps, each written once for every mode
+// ---------------------------------------------------------------------
+
+// fib(n) = fib(n-1) + fib(n-2); fib(93) is the largest that fits uint64_t
+template <typename Self>
+constexpr uint64_t fibStep(Self& self, size_t n) {
+    return n < 2 ? n : self(n - 1) + self(n - 2);
+}
+
+// Number of ways to choose k of n items, modulo a prime: the key packs
+// n and k into one integer, C(n, k) = C(n-1, k-1) + C(n-1, k)
+const uint64_t MODULUS = 1000000007;
+
+uint64_t binomialKey(uint64_t n, uint64_t k) {
+    return n << 32 | k;
+}
+
+template <typename Self>
+uint64_t binomialStep(Self& self, uint64_t key) {
+    uint64_t n = key >> 32, k = key & 0xFFFFFFFF;
+    if (k == 0 || k == n) {
+        return 1;
+    }
+    return (self(binomialKey(n - 1, k - 1)) + self(binomialKey(n - 1, k))) % MODULUS;
+}
+
+constexpr size_t FIB_TABLE_SIZE = 94;
+constexpr auto FIB_TABLE = memoTable<uint64_t, FIB_TABLE_SIZE, fibStep<TableLookup<uint64_t>>>();
+static_assert(FIB_TABLE[10] == 55, "computed by the compiler");
+
+double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+void printStats(const char* label, double seconds, const MemoStats& stats) {
+    cout << "  " << label << seconds * 1000 << " ms\t" << stats.misses << " misses, hit rate "
+         << stats.hitRate() * 100 << "%\t" << stats.entries << " entries\t" << stats.evictions << " evictions" << endl;
+}
+
+/*
+ * Function: benchmark
+ * Purpose: Answers 'queries' random C(n, k) mod p queries with n <= 400
+ * in each mode. Queries share most of their subproblems. About half of
+ * all calls hit even at best: every miss makes two calls, and the second
+ * one usually finds what the first one just computed. Misses are the
+ * number to watch: a too-small LRU cache recomputes evicted values.
+ */
+void benchmark(size_t queries) {
+    const uint64_t maxN = 400;
+    mt19937_64 rng(11);
+    vector<uint64_t> keys(queries);
+    for (uint64_t& key : keys) {
+        uint64_t n = 1 + rng() % maxN;
+        key = binomialKey(n, rng() % (n + 1));
+    }
+
+    using Plain = PlainCall<uint64_t, uint64_t>;
+    Plain plain(binomialStep<Plain>);
+    auto start = chrono::steady_clock::now();
+    uint64_t naive = plain(binomialKey(26, 13));
+    cout << "Without memoisation, C(26, 13) = " << naive << " takes " << plain.calls << " calls and "
+         << secondsSince(start) * 1000 << " ms" << endl << endl;
+
+    cout << queries << " queries C(n, k) mod p with n <= " << maxN << ":" << endl;
+    uint64_t expected = 0;
+    for (size_t capacity : {(size_t)100000, (size_t)40000, (size_t)20000}) {
+        using Lru = LruMemo<uint64_t, uint64_t>;
+        Lru memo(binomialStep<Lru>, capacity);
+        start = chrono::steady_clock::now();
+        uint64_t total = 0;
+        for (uint64_t key : keys) total += memo(key);
+        double seconds = secondsSince(start);
+        string label = "LruMemo, capacity " + to_string(capacity) + ":\t";
+        printStats(label.c_str(), seconds, memo.stats());
+        if (expected == 0) {
+            expected = total;
+        } else if (total != expected) {
+            cout << "  MISMATCH between modes!" << endl;
+        }
+    }
+
+    for (size_t threads : {(size_t)1, (size_t)4}) {
+        using Concurrent = ConcurrentMemo<uint64_t, uint64_t>;
+        Concurrent memo(binomialStep<Concurrent>);
+        atomic<uint64_t> total(0);
+        start = chrono::steady_clock::now();
+        vector<thread> workers;
+        for (size_t t = 0; t < threads; t++) {
+            workers.emplace_back([&, t] {
+                uint64_t mine = 0;
+                for (size_t i = t; i < keys.size(); i += threads) mine += memo(keys[i]);
+                total += mine;
+            });
+        }
+        for (thread& worker : workers) worker.join();
+        string label = "ConcurrentMemo, " + to_string(threads) + " thread(s):\t";
+        printStats(label.c_str(), secondsSince(start), memo.stats());
+        if (total != expected) {
+            cout << "  MISMATCH between modes!" << endl;
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+
+    cout << "fib(10) from the compile-time table: " << FIB_TABLE[10] << endl;
+    cout << "fib(93) from the compile-time table: " << FIB_TABLE[93] << endl;
+
+    using Lru = LruMemo<uint64_t, uint64_t>;
+    Lru fib(fibStep<Lru>, 1000);
+    cout << "fib(90) through LruMemo: " << fib(90);
+    cout << " (" << fib.stats().misses << " misses, " << fib.stats().hits << " hits)" << endl;
+    fib(90);
+    cout << "Asking again: " << fib.stats().hits << " hits, hit rate " << fib.stats().hitRate() * 100 << "%" << endl;
+    cout << endl;
+
+    size_t queries = 2000;
+    if (argc > 1) {
+        queries = strtoul(argv[1], nullptr, 10);
+    }
+    benchmark(queries);
+
+    /*
+     * Key Learning Points:
+     * 1. Overlapping subproblems make plain recursion exponentially slow
+     * 2. Writing the step with a 'self' parameter separates it from caching
+     * 3. constexpr tables move the whole computation to compile time
+     * 4. A bounded LRU cache trades hit rate for memory
+     * 5. Sharded locks let threads share one cache without a global lock
+     */
+
+    return 0;
+}
@@ -0,0 +1,424 @@
+/*
+ * C++ Microbenchmark Harness
+ * ==========================
+ *
+ * Every performance example in this repository times itself with its
+ * own steady_clock loop. This header is a shared harness for measuring
+ * single functions repeatably:
+ * - Warm-up: each benchmark runs for a while before anything is recorded
+ * - Calibration: the iteration count is doubled until one sample takes
+ *   long enough for the clock to measure it accurately
+ * - Statistics over many samples: median, p99, MAD (median absolute
+ *   deviation), min and mean, all in nanoseconds per operation
+ * - CPU pinning, so the scheduler cannot move the benchmark mid-run
+ * - JSON and CSV output, and a baseline mode that compares against an
+ *   earlier JSON file and flags regressions
+ *
+ * Concept: One timing of one call says little: the clock has a
+ * resolution of tens of nanoseconds and every run sees different cache,
+ * frequency and interrupt conditions. Timing batches of calls and taking
+ * the median over many batches gives a number that is stable from run to
+ * run; the MAD says how noisy it was, and a change is only reported as a
+ * regression when it is larger than both the threshold and the noise.
+ *
+ * Usage (see bench_examples.cpp):
+ *   BenchRunner runner;
+ *   runner.add("rgbToString", [&](size_t i) { doNotOptimize(rgbToString(colours[i % 3])); });
+ *   return runner.main(argc, argv);
+ */
+
+#ifndef MICROBENCH_H
+#define MICROBENCH_H
+
+#include <algorithm>   // For sort/nth_element
+#include <chrono>      // For timing samples
+#include <cmath>       // For fabs
+#include <cstdlib>     // For strtod/strtol
+#include <fstream>     // For JSON/CSV files
+#include <functional>  // For storing benchmarks
+#include <iostream>    // For the result table
+#include <map>         // For baseline results by name
+#include <sstream>     // For reading baseline files
+#include <string>      // For names and paths
+#include <vector>      // For samples and benchmarks
+#ifdef __linux__
+#include <sched.h>     // For sched_setaffinity/sched_getcpu
+#endif
+
+/*
+ * Function: doNotOptimize
+ * Purpose: Makes the compiler believe 'value' is read, so a computation
+ * whose result is otherwise unused is not removed
+ */
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Makes the compiler assume all memory may have been read and written
+inline void clobberMemory() {
+    asm volatile("" : : : "memory");
+}
+
+/*
+ * Struct: BenchOptions
+ * Purpose: Settings for one run, filled in from the command line by
+ * parseBenchOptions()
+ */
+struct BenchOptions {
+    double warmupMs = 50;       // Per benchmark, before recording
+    double sampleMs = 2;        // Target length of one sample
+    size_t samples = 101;       // Samples per benchmark
+    int cpu = -1;               // CPU to pin to; -1 = the one we start on, -2 = do not pin
+    double threshold = 0.10;    // Relative slowdown that counts as a regression
+    std::string filter;         // Only run benchmarks whose name contains this
+    std::string jsonPath;
+    std::string csvPath;
+    std::string baselinePath;
+};
+
+/*
+ * Struct: BenchResult
+ * Purpose: Summary of one benchmark; all times are ns per operation
+ */
+struct BenchResult {
+    std::string name;
+    size_t iterations = 0;  // Operations per sample, after calibration
+    size_t samples = 0;
+    double medianNs = 0;
+    double p99Ns = 0;
+    double madNs = 0;
+    double minNs = 0;
+    double meanNs = 0;
+};
+
+// Nearest-rank percentile of sorted values, p in [0, 1]
+inline double percentileOf(const std::vector<double>& sorted, double p) {
+    size_t rank = (size_t)std::ceil(p * sorted.size());
+    return sorted[rank == 0 ? 0 : rank - 1];
+}
+
+inline double medianOf(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    size_t middle = values.size() / 2;
+    return values.size() % 2 == 1 ? values[middle] : (values[middle - 1] + values[middle]) / 2;
+}
+
+/*
+ * Function: summarise
+ * Purpose: Turns raw per-operation sample times into a BenchResult
+ */
+inline BenchResult summarise(const std::string& name, size_t iterations, std::vector<double> samples) {
+    BenchResult result;
+    result.name = name;
+    result.iterations = iterations;
+    result.samples = samples.size();
+    if (samples.empty()) {
+        return result;
+    }
+    std::sort(samples.begin(), samples.end());
+    result.medianNs = medianOf(samples);
+    result.p99Ns = percentileOf(samples, 0.99);
+    result.minNs = samples.front();
+    double total = 0;
+    std::vector<double> deviations;
+    for (double s : samples) {
+        total += s;
+        deviations.push_back(std::fabs(s - result.medianNs));
+    }
+    result.meanNs = total / samples.size();
+    result.madNs = medianOf(deviations);
+    return result;
+}
+
+/*
+ * Function: pinToCpu
+ * Purpose: Restricts this thread to one CPU; returns false if that is
+ * not possible (other systems, or a CPU outside our allowed set)
+ */
+inline bool pinToCpu(int cpu) {
+#ifdef __linux__
+    if (cpu < 0) {
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+inline int currentCpu() {
+#ifdef __linux__
+    return sched_getcpu();
+#else
+    return -1;
+#endif
+}
+
+inline std::string jsonEscape(const std::string& text) {
+    std::string out;
+    for (char c : text) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+/*
+ * Function: writeJson
+ * Purpose: Writes results as JSON, one benchmark per line, so that
+ * readBaseline() can read it back without a full JSON parser
+ */
+inline bool writeJson(const std::string& path, const std::vector<BenchResult>& results, int cpu) {
+    std::ofstream out(path);
+    if (!out) {
+        return false;
+    }
+    out << "{\n  \"cpu\": " << cpu << ",\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        out << "    {\"name\": \"" << jsonEscape(r.name) << "\", \"iterations\": " << r.iterations
+            << ", \"samples\": " << r.samples << ", \"median_ns\": " << r.medianNs << ", \"p99_ns\": " << r.p99Ns
+            << ", \"mad_ns\": " << r.madNs << ", \"min_ns\": " << r.minNs << ", \"mean_ns\": " << r.meanNs << "}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+    return (bool)out;
+}
+
+inline bool writeCsv(const std::string& path, const std::vector<BenchResult>& results) {
+    std::ofstream out(path);
+    if (!out) {
+        return false;
+    }
+    out << "name,iterations,samples,median_ns,p99_ns,mad_ns,min_ns,mean_ns\n";
+    for (const BenchResult& r : results) {
+        out << r.name << "," << r.iterations << "," << r.samples << "," << r.medianNs << "," << r.p99Ns << ","
+            << r.madNs << "," << r.minNs << "," << r.meanNs << "\n";
+    }
+    return (bool)out;
+}
+
+// The number after "key": on 'line', or false if the key is missing
+inline bool jsonNumber(const std::string& line, const std::string& key, double& value) {
+    size_t at = line.find("\"" + key + "\": ");
+    if (at == std::string::npos) {
+        return false;
+    }
+    value = std::strtod(line.c_str() + at + key.size() + 4, nullptr);
+    return true;
+}
+
+/*
+ * Function: readBaseline
+ * Purpose: Reads a file written by writeJson() into results by name
+ * Returns false if the file cannot be opened.
+ */
+inline bool readBaseline(const std::string& path, std::map<std::string, BenchResult>& baseline) {
+    std::ifstream in(path);
+    if (!in) {
+        return false;
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t at = line.find("\"name\": \"");
+        if (at == std::string::npos) {
+            continue;
+        }
+        BenchResult r;
+        for (size_t i = at + 9; i < line.size() && line[i] != '"'; i++) {
+            if (line[i] == '\\' && i + 1 < line.size()) i++;
+            r.name += line[i];
+        }
+        if (jsonNumber(line, "median_ns", r.medianNs)) {
+            jsonNumber(line, "mad_ns", r.madNs);
+            jsonNumber(line, "p99_ns", r.p99Ns);
+            baseline[r.name] = r;
+        }
+    }
+    return true;
+}
+
+/*
+ * Function: parseBenchOptions
+ * Purpose: Reads --filter, --json, --csv, --baseline, --threshold,
+ * --cpu, --samples, --sample-ms and --warmup-ms; returns false (after
+ * printing usage) on anything else
+ */
+inline bool parseBenchOptions(int argc, char* argv[], BenchOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        bool known = value != nullptr;
+        if (arg == "--filter" && known) options.filter = value;
+        else if (arg == "--json" && known) options.jsonPath = value;
+        else if (arg == "--csv" && known) options.csvPath = value;
+        else if (arg == "--baseline" && known) options.baselinePath = value;
+        else if (arg == "--threshold" && known) options.threshold = std::strtod(value, nullptr);
+        else if (arg == "--cpu" && known) options.cpu = (int)std::strtol(value, nullptr, 10);
+        else if (arg == "--samples" && known) options.samples = std::max(1L, std::strtol(value, nullptr, 10));
+        else if (arg == "--sample-ms" && known) options.sampleMs = std::strtod(value, nullptr);
+        else if (arg == "--warmup-ms" && known) options.warmupMs = std::strtod(value, nullptr);
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--filter text] [--json file] [--csv file]\n"
+                      << "       [--baseline file] [--threshold 0.10] [--cpu n|-2] [--samples n]\n"
+                      << "       [--sample-ms ms] [--warmup-ms ms]" << std::endl;
+            return false;
+        }
+        i++;
+    }
+    return true;
+}
+
+/*
+ * Class: BenchRunner
+ * Purpose: Holds the registered benchmarks and runs them
+ * A benchmark body receives the number of operations to perform, so the
+ * per-operation work is inlined into its loop; add() builds that loop
+ * from a lambda taking the operation's index.
+ */
+class BenchRunner {
+    private:
+        struct Benchmark {
+            std::string name;
+            std::function<void(size_t)> body;
+        };
+
+        std::vector<Benchmark> benchmarks;
+
+        using Clock = std::chrono::steady_clock;
+
+        static double elapsedNs(const std::function<void(size_t)>& body, size_t iterations) {
+            auto start = Clock::now();
+            body(iterations);
+            return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        }
+
+        static BenchResult measure(const Benchmark& b, const BenchOptions& options) {
+            // Warm-up, which also gives a first estimate of the cost
+            size_t iterations = 1;
+            double spent = 0, last = 0;
+            while (spent < options.warmupMs * 1e6 || last < options.sampleMs * 1e6 / 4) {
+                last = elapsedNs(b.body, iterations);
+                spent += last;
+                if (last < options.sampleMs * 1e6 && iterations < ((size_t)1 << 40)) iterations *= 2;
+            }
+            // Calibration: scale to the target sample length
+            double perOp = last / iterations;
+            iterations = std::max<size_t>(1, (size_t)(options.sampleMs * 1e6 / std::max(perOp, 0.01)));
+
+            std::vector<double> samples;
+            samples.reserve(options.samples);
+            for (size_t s = 0; s < options.samples; s++) {
+                samples.push_back(elapsedNs(b.body, iterations) / iterations);
+            }
+            return summarise(b.name, iterations, samples);
+        }
+
+    public:
+        // 'body(iterations)' performs 'iterations' operations itself
+        void addLoop(const std::string& name, std::function<void(size_t)> body) {
+            benchmarks.push_back({name, std::move(body)});
+        }
+
+        // 'op(i)' performs operation number i
+        template <typename Op>
+        void add(const std::string& name, Op op) {
+            addLoop(name, [op](size_t iterations) mutable {
+                for (size_t i = 0; i < iterations; i++) {
+                    op(i);
+                }
+            });
+        }
+
+        // Runs every benchmark matching options.filter, in registration order
+        std::vector<BenchResult> run(const BenchOptions& options) const {
+            std::vector<BenchResult> results;
+            for (const Benchmark& b : benchmarks) {
+                if (b.name.find(options.filter) == std::string::npos) {
+                    continue;
+                }
+                results.push_back(measure(b, options));
+                const BenchResult& r = results.back();
+                std::cout << "  " << r.name << std::string(r.name.size() < 34 ? 34 - r.name.size() : 1, ' ')
+                          << "median " << r.medianNs << " ns  p99 " << r.p99Ns << " ns  MAD " << r.madNs
+                          << " ns  (" << r.samples << " x " << r.iterations << ")" << std::endl;
+            }
+            return results;
+        }
+
+        /*
+         * Function: compare
+         * Purpose: Prints each result against the baseline and returns the
+         * number of regressions: slower by more than the threshold and by
+         * more than three times the larger of the two MADs
+         */
+        static size_t compare(const std::vector<BenchResult>& results,
+                              const std::map<std::string, BenchResult>& baseline, double threshold) {
+            size_t regressions = 0;
+            std::cout << "Compared with baseline (median ns, threshold " << threshold * 100 << "%):" << std::endl;
+            for (const BenchResult& r : results) {
+                auto old = baseline.find(r.name);
+                if (old == baseline.end()) {
+                    std::cout << "  " << r.name << ": new" << std::endl;
+                    continue;
+                }
+                double before = old->second.medianNs;
+                double change = before > 0 ? r.medianNs / before - 1 : 0;
+                double noise = 3 * std::max(r.madNs, old->second.madNs);
+                const char* verdict = "same";
+                if (std::fabs(r.medianNs - before) > noise && std::fabs(change) > threshold) {
+                    verdict = change > 0 ? "REGRESSION" : "faster";
+                    regressions += change > 0;
+                }
+                std::cout << "  " << r.name << ": " << before << " -> " << r.medianNs << " ("
+                          << (change >= 0 ? "+" : "") << change * 100 << "%) " << verdict << std::endl;
+            }
+            return regressions;
+        }
+
+        /*
+         * Function: main
+         * Purpose: The whole command-line flow: parse options, pin, run,
+         * write files, compare. Returns the process exit code: 0 if all
+         * went well, 1 for bad arguments or files, 2 if regressions were found.
+         */
+        int main(int argc, char* argv[]) const {
+            BenchOptions options;
+            if (!parseBenchOptions(argc, argv, options)) {
+                return 1;
+            }
+            int cpu = options.cpu == -1 ? currentCpu() : options.cpu;
+            bool pinned = options.cpu != -2 && pinToCpu(cpu);
+            std::cout << "Pinned to CPU " << cpu << ": " << (pinned ? "yes" : "no") << ", " << options.samples
+                      << " samples of ~" << options.sampleMs << " ms each" << std::endl;
+
+            std::vector<BenchResult> results = run(options);
+
+            if (!options.jsonPath.empty() && !writeJson(options.jsonPath, results, pinned ? cpu : -1)) {
+                std::cerr << "Cannot write " << options.jsonPath << std::endl;
+                return 1;
+            }
+            if (!options.csvPath.empty() && !writeCsv(options.csvPath, results)) {
+                std::cerr << "Cannot write " << options.csvPath << std::endl;
+                return 1;
+            }
+            if (!options.baselinePath.empty()) {
+                std::map<std::string, BenchResult> baseline;
+                if (!readBaseline(options.baselinePath, baseline)) {
+                    std::cerr << "Cannot read baseline " << options.baselinePath << std::endl;
+                    return 1;
+                }
+                size_t regressions = compare(results, baseline, options.threshold);
+                std::cout << regressions << " regression(s)" << std::endl;
+                return regressions > 0 ? 2 : 0;
+            }
+            return 0;
+        }
+};
+
+#endif
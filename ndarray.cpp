@@ -0,0 +1,490 @@
+/*
+ * C++ N-Dimensional Array Examples
+ * ================================
+ *
+ * multidimenional.cpp uses string letters[2][2][2]: the size is fixed at
+ * compile time and every rank needs its own hand-written nested loops.
+ * This file demonstrates an ndarray<T, Rank> for data sized at runtime:
+ * - One contiguous allocation for all elements, whatever the rank
+ * - Row-major (C order), column-major (Fortran order) or custom strides
+ * - ndview: zero-copy slices (fix one index) and subviews (ranges and
+ *   steps, negative ones too), sharing the array's memory
+ * - Flat iteration: a plain pointer loop when the view is contiguous, and
+ *   a strided iterator that visits any view in row-major order
+ * - A benchmark against vector<vector<vector<double>>>
+ *
+ * Concept: An element's address is data + i*stride0 + j*stride1 + ...
+ * With row-major strides of a 3 x 4 x 5 array (20, 5, 1), moving along
+ * the last index moves one element in memory. Slicing, subviews and
+ * transposing only change the start pointer, shape and strides, never
+ * the elements, so they cost nothing however large the array is.
+ * A vector of vectors instead allocates every row separately: traversal
+ * jumps between allocations and a slice has to be copied out.
+ *
+ * Usage: ./ndarray [size of each dimension]   (default: 200)
+ */
+
+#include <array>      // For shape and stride arrays
+#include <chrono>     // For timing the benchmark
+#include <cstddef>    // For ptrdiff_t
+#include <cstdlib>    // For strtoul
+#include <functional> // For plus
+#include <iostream>   // For input/output operations
+#include <string>     // For string class
+#include <utility>    // For move
+#include <vector>     // For storage and the vector-of-vectors baseline
+using namespace std;
+
+enum Layout {
+    ROW_MAJOR,    // Last index is contiguous (C arrays)
+    COLUMN_MAJOR  // First index is contiguous (Fortran, MATLAB)
+};
+
+/*
+ * Class: ndview
+ * Purpose: A non-owning view of Rank-dimensional data with any strides
+ * Strides are counted in elements and may be negative (a reversed view).
+ * Views are cheap to copy; they must not outlive the array they view.
+ */
+template <typename T, size_t Rank>
+class ndview {
+    static_assert(Rank >= 1, "ndview needs at least one dimension");
+
+    private:
+        T* base;
+        array<ptrdiff_t, Rank> extents;
+        array<ptrdiff_t, Rank> steps;
+
+    public:
+        ndview(T* data, const array<ptrdiff_t, Rank>& shape, const array<ptrdiff_t, Rank>& strides)
+            : base(data), extents(shape), steps(strides) {}
+
+        template <typename... Index>
+        T& operator()(Index... index) const {
+            static_assert(sizeof...(Index) == Rank, "one index per dimension");
+            const ptrdiff_t at[] = {(ptrdiff_t)index...};
+            ptrdiff_t offset = 0;
+            for (size_t d = 0; d < Rank; d++) {
+                offset += at[d] * steps[d];
+            }
+            return base[offset];
+        }
+
+        T* data() const { return base; }
+        ptrdiff_t shape(size_t dim) const { return extents[dim]; }
+        ptrdiff_t stride(size_t dim) const { return steps[dim]; }
+
+        ptrdiff_t size() const {
+            ptrdiff_t n = 1;
+            for (ptrdiff_t e : extents) n *= e;
+            return n;
+        }
+
+        // True if the elements are packed in row-major order, so that the
+        // whole view is the range [data(), data() + size())
+        bool isContiguous() const {
+            ptrdiff_t expected = 1;
+            for (size_t d = Rank; d-- > 0;) {
+                if (extents[d] != 1 && steps[d] != expected) {
+                    return false;
+                }
+                expected *= extents[d];
+            }
+            return true;
+        }
+
+        // Fixes index 'index' of dimension 'dim': a 3D view gives a 2D plane
+        auto slice(size_t dim, ptrdiff_t index) const {
+            static_assert(Rank > 1, "slicing a 1D view would give a single element");
+            array<ptrdiff_t, Rank - 1> shape, strides;
+            for (size_t d = 0, out = 0; d < Rank; d++) {
+                if (d != dim) {
+                    shape[out] = extents[d];
+                    strides[out] = steps[d];
+                    out++;
+                }
+            }
+            return ndview<T, Rank - 1>(base + index * steps[dim], shape, strides);
+        }
+
+        // Keeps indices start, start+step, ... (before stop) of dimension 'dim'
+        // A negative step walks down from start, as in Python: sub(d, n - 1,
+        // -1, -1) reverses dimension d. A step of 0 gives an empty view.
+        ndview sub(size_t dim, ptrdiff_t start, ptrdiff_t stop, ptrdiff_t step = 1) const {
+            ndview result = *this;
+            if (step > 0) {
+                result.extents[dim] = stop > start ? (stop - start + step - 1) / step : 0;
+            } else if (step < 0) {
+                result.extents[dim] = start > stop ? (start - stop - step - 1) / -step : 0;
+            } else {
+                result.extents[dim] = 0;
+            }
+            if (result.extents[dim] > 0) {
+                result.base = base + start * steps[dim];
+            }
+            result.steps[dim] = steps[dim] * step;
+            return result;
+        }
+
+        // The same shape and strides over other memory
+        ndview rebased(T* data) const {
+            ndview result = *this;
+            result.base = data;
+            return result;
+        }
+
+        // Reverses the order of the dimensions: a matrix transpose for Rank 2
+        ndview transposed() const {
+            ndview result = *this;
+            for (size_t d = 0; d < Rank; d++) {
+                result.extents[d] = extents[Rank - 1 - d];
+                result.steps[d] = steps[Rank - 1 - d];
+            }
+            return result;
+        }
+
+        /*
+         * Class: iterator
+         * Purpose: Visits every element of any view in row-major order
+         * Moving on is one pointer add and a compare with the end of the
+         * current row; only at the end of a row are the outer indices
+         * carried (like an odometer). A contiguous view is one long row.
+         */
+        class iterator {
+            private:
+                const ndview* view;
+                ptrdiff_t at;      // Offsets from view->base, not pointers: with negative
+                ptrdiff_t rowEnd;  // strides the end of a row lies before the array
+                ptrdiff_t innerStep;
+                array<ptrdiff_t, Rank> index;  // Outer indices; the last one is unused
+                ptrdiff_t remaining;
+                bool flat;
+
+                void nextRow() {
+                    at -= innerStep * view->extents[Rank - 1];
+                    for (size_t d = Rank - 1; d-- > 0;) {
+                        at += view->steps[d];
+                        if (++index[d] < view->extents[d]) {
+                            break;
+                        }
+                        at -= view->steps[d] * view->extents[d];
+                        index[d] = 0;
+                    }
+                    rowEnd = at + innerStep * view->extents[Rank - 1];
+                }
+
+            public:
+                iterator(const ndview* v, ptrdiff_t count)
+                    : view(v), at(0), innerStep(v->steps[Rank - 1]), index(), remaining(count),
+                      flat(v->isContiguous()) {
+                    rowEnd = flat ? at + v->size() : at + innerStep * v->extents[Rank - 1];
+                }
+
+                T& operator*() const { return view->base[at]; }
+                bool operator!=(const iterator& other) const { return remaining != other.remaining; }
+
+                iterator& operator++() {
+                    remaining--;
+                    at += flat ? 1 : innerStep;
+                    if (at == rowEnd && !flat) {
+                        nextRow();
+                    }
+                    return *this;
+                }
+        };
+
+        iterator begin() const { return iterator(this, size()); }
+        iterator end() const { return iterator(this, 0); }
+
+        /*
+         * Function: forEach
+         * Purpose: Calls f(element) for every element, as fast as the
+         * layout allows: a contiguous view is one pointer loop; otherwise
+         * the outer dimensions loop and the innermost runs with a fixed stride.
+         */
+        template <typename F>
+        void forEach(F f) const {
+            if (isContiguous()) {
+                for (T *p = base, *last = base + size(); p != last; ++p) {
+                    f(*p);
+                }
+            } else {
+                forEachFrom<0>(base, f);
+            }
+        }
+
+        // Combines all elements with 'op', starting from 'init' (a sum for
+        // plus<>()). Elements are visited in the same order as forEach.
+        // The accumulator is a local value rather than a captured
+        // reference, so the compiler can keep it in a register.
+        template <typename U, typename Op>
+        U reduce(U init, Op op) const {
+            if (isContiguous()) {
+                for (T *p = base, *last = base + size(); p != last; ++p) {
+                    init = op(init, *p);
+                }
+                return init;
+            }
+            return reduceFrom<0>(base, init, op);
+        }
+
+    private:
+        template <size_t D, typename U, typename Op>
+        U reduceFrom(T* start, U acc, Op& op) const {
+            if constexpr (D + 1 == Rank) {
+                ptrdiff_t step = steps[D];
+                for (ptrdiff_t i = 0, n = extents[D]; i < n; i++) {
+                    acc = op(acc, start[i * step]);
+                }
+            } else {
+                for (ptrdiff_t i = 0; i < extents[D]; i++) {
+                    acc = reduceFrom<D + 1>(start + i * steps[D], acc, op);
+                }
+            }
+            return acc;
+        }
+
+        template <size_t D, typename F>
+        void forEachFrom(T* start, F& f) const {
+            if constexpr (D + 1 == Rank) {
+                ptrdiff_t step = steps[D];
+                for (ptrdiff_t i = 0, n = extents[D]; i < n; i++) {
+                    f(start[i * step]);
+                }
+            } else {
+                for (ptrdiff_t i = 0; i < extents[D]; i++) {
+                    forEachFrom<D + 1>(start + i * steps[D], f);
+                }
+            }
+        }
+};
+
+/*
+ * Class: ndarray
+ * Purpose: Owns Rank-dimensional data in a single allocation
+ * All view operations (slice, sub, transposed, iteration) come from the
+ * ndview returned by view().
+ */
+template <typename T, size_t Rank>
+class ndarray {
+    private:
+        vector<T> storage;
+        ndview<T, Rank> whole;
+
+        static array<ptrdiff_t, Rank> stridesFor(const array<ptrdiff_t, Rank>& shape, Layout layout) {
+            array<ptrdiff_t, Rank> strides;
+            ptrdiff_t step = 1;
+            for (size_t i = 0; i < Rank; i++) {
+                size_t d = layout == ROW_MAJOR ? Rank - 1 - i : i;
+                strides[d] = step;
+                step *= shape[d];
+            }
+            return strides;
+        }
+
+        static size_t storageFor(const array<ptrdiff_t, Rank>& shape, const array<ptrdiff_t, Rank>& strides) {
+            ptrdiff_t last = 0;
+            for (size_t d = 0; d < Rank; d++) {
+                if (shape[d] == 0) {
+                    return 0;
+                }
+                last += (shape[d] - 1) * strides[d];
+            }
+            return (size_t)last + 1;
+        }
+
+    public:
+        explicit ndarray(const array<ptrdiff_t, Rank>& shape, Layout layout = ROW_MAJOR, const T& fill = T())
+            : ndarray(shape, stridesFor(shape, layout), fill) {}
+
+        // Custom strides (non-negative, in elements), e.g. to pad rows to a
+        // multiple of a cache line
+        ndarray(const array<ptrdiff_t, Rank>& shape, const array<ptrdiff_t, Rank>& strides, const T& fill = T())
+            : storage(storageFor(shape, strides), fill), whole(storage.data(), shape, strides) {}
+
+        ndarray(const ndarray& other) : storage(other.storage), whole(other.whole.rebased(storage.data())) {}
+
+        ndarray(ndarray&& other) = default;  // vector's buffer moves with it
+        ndarray& operator=(ndarray other) {
+            storage.swap(other.storage);
+            swap(whole, other.whole);
+            return *this;
+        }
+
+        template <typename... Index>
+        T& operator()(Index... index) { return whole(index...); }
+
+        template <typename... Index>
+        const T& operator()(Index... index) const { return whole(index...); }
+
+        ndview<T, Rank> view() { return whole; }
+        ndview<const T, Rank> view() const {
+            array<ptrdiff_t, Rank> shape, strides;
+            for (size_t d = 0; d < Rank; d++) {
+                shape[d] = whole.shape(d);
+                strides[d] = whole.stride(d);
+            }
+            return ndview<const T, Rank>(whole.data(), shape, strides);
+        }
+
+        ptrdiff_t shape(size_t dim) const { return whole.shape(dim); }
+        ptrdiff_t size() const { return whole.size(); }
+};
+
+/*
+ * Function: print
+ * Purpose: Prints a view of any rank: rows on lines, planes separated by
+ * blank lines. Replaces one_dim(), two_dim() and three_dim()'s loops.
+ */
+template <typename T, size_t Rank>
+void print(const ndview<T, Rank>& view) {
+    if constexpr (Rank == 1) {
+        for (const auto& element : view) {
+            cout << element << "\t";
+        }
+        cout << "\n";
+    } else {
+        for (ptrdiff_t i = 0; i < view.shape(0); i++) {
+            print(view.slice(0, i));
+        }
+        if (Rank > 2) {
+            cout << "\n";
+        }
+    }
+}
+
+double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+/*
+ * Function: benchmark
+ * Purpose: Sums an n x n x n grid, then extracts and sums planes along
+ * the first and last dimension, with ndarray and with nested vectors
+ */
+void benchmark(ptrdiff_t n) {
+    cout << "Grid of " << n << " x " << n << " x " << n << " doubles ("
+         << n * n * n * 8 / (1024 * 1024) << " MB):" << endl;
+
+    ndarray<double, 3> grid({n, n, n});
+    vector<vector<vector<double>>> nested(n, vector<vector<double>>(n, vector<double>(n)));
+    for (ptrdiff_t i = 0; i < n; i++) {
+        for (ptrdiff_t j = 0; j < n; j++) {
+            for (ptrdiff_t k = 0; k < n; k++) {
+                double v = (double)((i * 7 + j * 3 + k) % 100);
+                grid(i, j, k) = v;
+                nested[i][j][k] = v;
+            }
+        }
+    }
+
+    cout << "  Full traversal (ms):" << endl;
+    auto start = chrono::steady_clock::now();
+    double nestedSum = 0;
+    for (const auto& plane : nested) {
+        for (const auto& row : plane) {
+            for (double v : row) nestedSum += v;
+        }
+    }
+    cout << "    vector<vector<vector>>:   " << secondsSince(start) * 1000 << endl;
+
+    start = chrono::steady_clock::now();
+    double indexSum = 0;
+    for (ptrdiff_t i = 0; i < n; i++) {
+        for (ptrdiff_t j = 0; j < n; j++) {
+            for (ptrdiff_t k = 0; k < n; k++) indexSum += grid(i, j, k);
+        }
+    }
+    cout << "    ndarray grid(i, j, k):    " << secondsSince(start) * 1000 << endl;
+
+    start = chrono::steady_clock::now();
+    double flatSum = grid.view().reduce(0.0, plus<double>());
+    cout << "    ndarray reduce:           " << secondsSince(start) * 1000 << endl;
+
+    start = chrono::steady_clock::now();
+    double iterSum = 0;
+    for (double v : grid.view()) iterSum += v;
+    cout << "    ndarray iterator:         " << secondsSince(start) * 1000 << endl;
+
+    // Extract every plane along dimension 0 (contiguous) and 2 (strided),
+    // as a function taking a 2D argument would need it
+    cout << "  Extract and sum all " << n << " planes along a dimension (ms):" << endl;
+    double nestedSlices = 0, viewSlices = 0;
+    for (int dim : {0, 2}) {
+        start = chrono::steady_clock::now();
+        for (ptrdiff_t s = 0; s < n; s++) {
+            vector<vector<double>> plane(n, vector<double>(n));
+            for (ptrdiff_t a = 0; a < n; a++) {
+                for (ptrdiff_t b = 0; b < n; b++) {
+                    plane[a][b] = dim == 0 ? nested[s][a][b] : nested[a][b][s];
+                }
+            }
+            for (const auto& row : plane) {
+                for (double v : row) nestedSlices += v;
+            }
+        }
+        double copyTime = secondsSince(start) * 1000;
+
+        start = chrono::steady_clock::now();
+        for (ptrdiff_t s = 0; s < n; s++) {
+            viewSlices += grid.view().slice(dim, s).reduce(0.0, plus<double>());
+        }
+        double viewTime = secondsSince(start) * 1000;
+        cout << "    dimension " << dim << ": nested copy " << copyTime
+             << ", ndview slice " << viewTime << endl;
+    }
+
+    if (nestedSum != indexSum || nestedSum != flatSum || nestedSum != iterSum || nestedSlices != viewSlices) {
+        cout << "  MISMATCH between methods!" << endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+
+    // three_dim() from multidimenional.cpp, sized at runtime
+    const char* names[] = {"A", "B", "C", "D", "E", "F", "J", "K"};
+    ndarray<string, 3> letters({2, 2, 2});
+    int next = 0;
+    for (string& letter : letters.view()) {
+        letter = names[next++];
+    }
+    cout << "Three DIM" << endl;
+    print(letters.view());
+
+    cout << "Second plane, as a 2D slice (no copy):" << endl;
+    print(letters.view().slice(0, 1));
+
+    cout << "Subview of every second element along the last dimension:" << endl;
+    print(letters.view().sub(2, 0, 2, 2));
+
+    cout << "First dimension reversed (a negative stride, no copy):" << endl;
+    print(letters.view().sub(0, 1, -1, -1));
+
+    ndarray<int, 2> matrix({2, 3}, COLUMN_MAJOR);
+    for (int i = 0; i < 2; i++) {
+        for (int j = 0; j < 3; j++) matrix(i, j) = i * 3 + j;
+    }
+    cout << "Column-major 2 x 3 matrix, strides (" << matrix.view().stride(0) << ", "
+         << matrix.view().stride(1) << "):" << endl;
+    print(matrix.view());
+    cout << "Transposed view:" << endl;
+    print(matrix.view().transposed());
+    cout << endl;
+
+    ptrdiff_t n = 200;
+    if (argc > 1) {
+        n = (ptrdiff_t)strtoul(argv[1], nullptr, 10);
+    }
+    benchmark(n);
+
+    /*
+     * Key Learning Points:
+     * 1. One allocation plus strides describes an array of any rank
+     * 2. Row- and column-major are just different strides
+     * 3. Slices, subviews and transposes are views: no elements are copied
+     * 4. Contiguous views can be walked as a single flat loop
+     * 5. Nested vectors scatter rows over the heap and make slices expensive
+     */
+
+    return 0;
+}
@@ -0,0 +1,418 @@
+/*
+ * C++ Fast Number Formatting and Parsing
+ * ======================================
+ *
+ * scientific_number.cpp prints 32e3 and 14E4 with cout. That works, but
+ * cout is locale-aware (slow), and by default prints only 6 significant
+ * digits, so reading the text back may give a different number. This file
+ * shows a small number I/O module:
+ * - formatShortest(): the shortest text that reads back as exactly the
+ *   same float/double, in plain or scientific form
+ * - parseNumber(): an exact parser for "14E4", "-0.5", "3.2e+04" ...
+ * - NumberReader: parses numbers one after another straight out of a big
+ *   text buffer, without copying it into strings or streams
+ * - A round-trip check against strtod and a throughput benchmark against
+ *   iostream and printf/strtod
+ *
+ * Concept: Formatting uses std::to_chars (C++17), which in libstdc++ is
+ * implemented with the Ryu algorithm: it finds the shortest digit string
+ * inside the interval of decimals that round to our value, using only
+ * integer arithmetic. Parsing has a fast path: when the digits fit in
+ * 53 bits and the power of ten is at most 10^22, both are exact doubles,
+ * so one multiply or divide gives the correctly rounded answer (Clinger's
+ * observation). Everything else goes to std::from_chars, which is exact.
+ *
+ * Usage: ./numio [count]   (default: 2000000)
+ */
+
+#include <charconv>      // For to_chars/from_chars (C++17)
+#include <chrono>        // For timing the benchmark
+#include <cmath>         // For HUGE_VAL
+#include <cstdint>       // For uint64_t
+#include <cstdio>        // For snprintf
+#include <cstdlib>       // For strtod/strtoul
+#include <cstring>       // For memcpy
+#include <iomanip>       // For setprecision
+#include <iostream>      // For input/output operations
+#include <random>        // For test values
+#include <sstream>       // For the iostream baseline
+#include <string>        // For string class
+#include <system_error>  // For errc
+#include <vector>        // For test data
+using namespace std;
+
+// Longest shortest-form double, e.g. "-2.2250738585072014e-308", plus room
+const size_t MAX_NUMBER_CHARS = 32;
+
+enum NumberStyle {
+    GENERAL,     // "32000" or "1e+300", whichever is shorter
+    SCIENTIFIC   // Always "3.2e+04"
+};
+
+/*
+ * Function: formatShortest
+ * Purpose: Writes the shortest round-trip text for 'value' into 'out'
+ * (which needs MAX_NUMBER_CHARS bytes) and returns a pointer past the
+ * last character. No locale, no allocation, no null terminator.
+ */
+template <typename T>
+char* formatShortest(char* out, T value, NumberStyle style = GENERAL) {
+    to_chars_result r = style == SCIENTIFIC
+        ? to_chars(out, out + MAX_NUMBER_CHARS, value, chars_format::scientific)
+        : to_chars(out, out + MAX_NUMBER_CHARS, value);
+    return r.ptr;
+}
+
+template <typename T>
+string toString(T value, NumberStyle style = GENERAL) {
+    char buffer[MAX_NUMBER_CHARS];
+    return string(buffer, formatShortest(buffer, value, style));
+}
+
+// Powers of ten that are exactly representable as doubles
+const double EXACT_POW10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                              1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+/*
+ * Function: parseNumber
+ * Purpose: Parses one number at 'first' (no leading spaces) into 'value'
+ * Accepts an optional sign, digits with an optional '.', and an optional
+ * exponent (e or E, optional sign, digits); also "inf" and "nan".
+ * Returns a pointer past the number, or nullptr if there is no number.
+ * The result is always the correctly rounded double, like strtod.
+ */
+const char* parseNumber(const char* first, const char* last, double& value) {
+    const char* p = first;
+    bool negative = false;
+    if (p < last && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        p++;
+    }
+    const char* digitsStart = p;
+
+    // Fast path: collect up to 19 significant digits in a uint64_t
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    bool exact = true;
+    while (p < last && *p >= '0' && *p <= '9') {
+        if (digits < 19) {
+            mantissa = mantissa * 10 + (*p - '0');
+            digits += mantissa != 0;
+        } else {
+            exact = false;
+        }
+        p++;
+    }
+    bool sawDigit = p > digitsStart;
+    if (p < last && *p == '.') {
+        p++;
+        const char* fraction = p;
+        while (p < last && *p >= '0' && *p <= '9') {
+            if (digits < 19) {
+                mantissa = mantissa * 10 + (*p - '0');
+                digits += mantissa != 0;
+                exponent--;
+            } else {
+                exact = false;
+            }
+            p++;
+        }
+        sawDigit = sawDigit || p > fraction;
+    }
+    if (!sawDigit) {
+        // Not a plain number: maybe "inf" or "nan"
+        from_chars_result r = from_chars(digitsStart, last, value);
+        if (r.ec != errc() || digitsStart == last || (*digitsStart != 'i' && *digitsStart != 'n' &&
+                                                      *digitsStart != 'I' && *digitsStart != 'N')) {
+            return nullptr;
+        }
+        value = negative ? -value : value;
+        return r.ptr;
+    }
+    int writtenExponent = 0;  // The number after 'e', if any
+    if (p < last && (*p == 'e' || *p == 'E')) {
+        const char* e = p + 1;
+        bool negativeExp = false;
+        if (e < last && (*e == '-' || *e == '+')) {
+            negativeExp = *e == '-';
+            e++;
+        }
+        if (e < last && *e >= '0' && *e <= '9') {
+            int exp = 0;
+            while (e < last && *e >= '0' && *e <= '9') {
+                if (exp < 100000) {
+                    exp = exp * 10 + (*e - '0');
+                }
+                e++;
+            }
+            writtenExponent = negativeExp ? -exp : exp;
+            exponent += writtenExponent;
+            p = e;
+        }
+    }
+
+    if (exact && mantissa <= (1ull << 53) && exponent >= -22 && exponent <= 22) {
+        double m = (double)mantissa;
+        value = exponent < 0 ? m / EXACT_POW10[-exponent] : m * EXACT_POW10[exponent];
+        value = negative ? -value : value;
+        return p;
+    }
+
+    // Slow path: std::from_chars is exact for any input. It does not take
+    // a '+' sign, so start it after the sign and apply the sign ourselves.
+    from_chars_result r = from_chars(digitsStart, p, value);
+    if (r.ec == errc::result_out_of_range) {
+        // Like strtod: overflow gives infinity, underflow gives zero. It
+        // overflowed if the first nonzero digit is worth 10^0 or more.
+        const char* q = digitsStart;
+        while (q < p && (*q == '0' || *q == '.')) q++;
+        const char* point = digitsStart;
+        while (point < p && *point >= '0' && *point <= '9') point++;
+        long leading = q < point ? point - q - 1 : -(q - point);  // Power of ten of that digit
+        value = leading + writtenExponent >= 0 ? HUGE_VAL : 0.0;
+    } else if (r.ec != errc()) {
+        return nullptr;
+    }
+    value = negative ? -value : value;
+    return p;
+}
+
+/*
+ * Class: NumberReader
+ * Purpose: Streams numbers out of a text buffer
+ * Spaces, tabs, newlines, commas and semicolons between numbers are
+ * skipped. The buffer is read in place and must outlive the reader.
+ */
+class NumberReader {
+    private:
+        const char* at;
+        const char* end;
+
+        static bool isSeparator(char c) {
+            return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == ',' || c == ';';
+        }
+
+    public:
+        NumberReader(const char* data, size_t size) : at(data), end(data + size) {}
+
+        // Reads the next number. Returns false at the end of the buffer or
+        // on text that is not a number (position() then points at it).
+        bool next(double& value) {
+            while (at < end && isSeparator(*at)) {
+                at++;
+            }
+            if (at == end) {
+                return false;
+            }
+            const char* after = parseNumber(at, end, value);
+            if (after == nullptr) {
+                return false;
+            }
+            at = after;
+            return true;
+        }
+
+        const char* position() const { return at; }
+        bool finished() const { return at == end; }
+};
+
+// Checks that formatting then parsing gives back the same bits
+bool sameBits(double a, double b) {
+    uint64_t x, y;
+    memcpy(&x, &a, 8);
+    memcpy(&y, &b, 8);
+    return x == y;
+}
+
+/*
+ * Function: roundTripCheck
+ * Purpose: For random bit patterns, formats the double and reads it back
+ * with strtod and with parseNumber (floats with strtof); also checks
+ * parseNumber against strtod on random decimal strings of many shapes.
+ */
+bool roundTripCheck(size_t count) {
+    mt19937_64 rng(99);
+    char buffer[MAX_NUMBER_CHARS + 1];
+    for (size_t i = 0; i < count; i++) {
+        uint64_t bits = rng();
+        double v;
+        memcpy(&v, &bits, 8);
+        if (v != v || v - v != 0) {
+            continue;  // Skip NaN and infinity
+        }
+        for (NumberStyle style : {GENERAL, SCIENTIFIC}) {
+            char* end = formatShortest(buffer, v, style);
+            *end = '\0';
+            double viaStrtod = strtod(buffer, nullptr);
+            double viaParser = 0;
+            if (!sameBits(viaStrtod, v) || parseNumber(buffer, end, viaParser) != end ||
+                !sameBits(viaParser, v)) {
+                cout << "  Round trip failed for " << buffer << endl;
+                return false;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        uint32_t bits = (uint32_t)rng();
+        float v;
+        memcpy(&v, &bits, 4);
+        if (v != v || v - v != 0) {
+            continue;
+        }
+        char* end = formatShortest(buffer, v);
+        *end = '\0';
+        float back = strtof(buffer, nullptr);
+        if (memcmp(&back, &v, 4) != 0) {
+            cout << "  Float round trip failed for " << buffer << endl;
+            return false;
+        }
+    }
+
+    const char* signs[] = {"", "-", "+"};
+    for (size_t i = 0; i < count; i++) {
+        string s = signs[rng() % 3];
+        int intDigits = (int)(rng() % 22);
+        for (int k = 0; k < intDigits; k++) s += (char)('0' + rng() % 10);
+        if (rng() % 2 || intDigits == 0) {
+            s += '.';
+            int fracDigits = (int)(rng() % 22) + (intDigits == 0);
+            for (int k = 0; k < fracDigits; k++) s += (char)('0' + rng() % 10);
+        }
+        if (rng() % 2) {
+            s += (rng() % 2) ? 'e' : 'E';
+            s += signs[rng() % 3];
+            s += to_string(rng() % 330);
+        }
+        double expected = strtod(s.c_str(), nullptr);
+        double got = 0;
+        const char* end = parseNumber(s.data(), s.data() + s.size(), got);
+        if (end != s.data() + s.size() || !sameBits(got, expected)) {
+            cout << "  Parse mismatch for \"" << s << "\"" << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+/*
+ * Function: benchmark
+ * Purpose: Formats and parses 'count' doubles with each method and prints
+ * millions of numbers per second. printf/iostream use 17 digits, the
+ * fewest that always round-trip without a shortest-form algorithm.
+ */
+void benchmark(size_t count) {
+    mt19937_64 rng(3);
+    uniform_real_distribution<double> mantissa(1.0, 10.0);
+    vector<double> values(count);
+    for (double& v : values) {
+        v = mantissa(rng) * EXACT_POW10[rng() % 23] * (rng() % 2 ? 1e-20 : 1.0);
+    }
+
+    cout << "Formatting " << count << " doubles (M numbers/s):" << endl;
+
+    auto start = chrono::steady_clock::now();
+    ostringstream stream;
+    stream << setprecision(17);
+    for (double v : values) stream << v << '\n';
+    string iostreamText = stream.str();
+    cout << "  iostream:            " << count / secondsSince(start) / 1e6 << endl;
+
+    start = chrono::steady_clock::now();
+    string printfText;
+    printfText.reserve(count * 25);
+    char buffer[64];
+    for (double v : values) {
+        int n = snprintf(buffer, sizeof(buffer), "%.17g\n", v);
+        printfText.append(buffer, n);
+    }
+    cout << "  snprintf(%.17g):     " << count / secondsSince(start) / 1e6 << endl;
+
+    start = chrono::steady_clock::now();
+    string text(count * (MAX_NUMBER_CHARS + 1), '\0');
+    char* out = &text[0];
+    for (double v : values) {
+        out = formatShortest(out, v, SCIENTIFIC);
+        *out++ = '\n';
+    }
+    text.resize(out - text.data());
+    cout << "  formatShortest:      " << count / secondsSince(start) / 1e6
+         << "  (" << text.size() << " bytes vs " << printfText.size() << ")" << endl;
+
+    cout << "Parsing them back (M numbers/s):" << endl;
+
+    start = chrono::steady_clock::now();
+    istringstream in(iostreamText);
+    double v;
+    double sum1 = 0;
+    while (in >> v) sum1 += v;
+    cout << "  iostream:            " << count / secondsSince(start) / 1e6 << endl;
+
+    start = chrono::steady_clock::now();
+    const char* p = printfText.c_str();
+    char* endp;
+    double sum2 = 0;
+    for (size_t i = 0; i < count; i++) {
+        sum2 += strtod(p, &endp);
+        p = endp;
+    }
+    cout << "  strtod:              " << count / secondsSince(start) / 1e6 << endl;
+
+    start = chrono::steady_clock::now();
+    NumberReader reader(text.data(), text.size());
+    double sum3 = 0;
+    size_t parsed = 0;
+    while (reader.next(v)) {
+        sum3 += v;
+        parsed++;
+    }
+    cout << "  NumberReader:        " << count / secondsSince(start) / 1e6 << endl;
+
+    if (parsed != count || sum1 != sum3 || sum2 != sum3) {
+        cout << "  MISMATCH between methods!" << endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+
+    float f1 = 32e3;
+    double d = 14E4;
+
+    cout << "cout:           " << f1 << "  " << d << "  " << 0.1 + 0.2 << endl;
+    cout << "formatShortest: " << toString(f1) << "  " << toString(d) << "  " << toString(0.1 + 0.2) << endl;
+    cout << "scientific:     " << toString(f1, SCIENTIFIC) << "  " << toString(d, SCIENTIFIC) << endl;
+
+    const string input = "32e3, 14E4, -0.5; 2.5e-3 1e310 inf";
+    NumberReader reader(input.data(), input.size());
+    double value;
+    cout << "Parsed:         ";
+    while (reader.next(value)) {
+        cout << toString(value) << "  ";
+    }
+    cout << endl << endl;
+
+    size_t count = 2000000;
+    if (argc > 1) {
+        count = strtoul(argv[1], nullptr, 10);
+    }
+    cout << "Round-trip check against strtod: "
+         << (roundTripCheck(count / 4) ? "passed" : "FAILED") << endl << endl;
+    benchmark(count);
+
+    /*
+     * Key Learning Points:
+     * 1. cout shows 6 significant digits by default: 0.1 + 0.2 looks like 0.3
+     * 2. The shortest round-trip form is both exact and compact
+     * 3. std::to_chars/from_chars ignore locales and never allocate
+     * 4. Small integers times exact powers of ten can be parsed with one
+     *    floating-point operation; rare hard cases need a slower exact path
+     * 5. Parsing in place from a buffer avoids copying into strings/streams
+     */
+
+    return 0;
+}
@@ -0,0 +1,391 @@
+/*
+ * C++ Parallel Reduction Examples
+ * ===============================
+ *
+ * sum() in recursion.cpp adds 1..x with one recursive call per number.
+ * That uses one stack frame per element (a large x overflows the stack)
+ * and an int result (x = 70000 already overflows). This file demonstrates
+ * a reduction engine for the same job on large ranges:
+ * - reduceRange(): splits a range in halves, runs the halves as parallel
+ *   tasks on a pool of reused threads, and combines the results with any
+ *   associative operator
+ * - Leaves of at least GRAIN elements run a plain loop that the compiler
+ *   vectorises (compiled for SSE2 and AVX2, chosen at startup)
+ * - 64-bit accumulators for 32-bit data, and a checked accumulator that
+ *   reports overflow instead of wrapping around
+ * - A benchmark against one-call-per-element recursion, std::accumulate
+ *   and std::reduce
+ *
+ * Concept: Divide and conquer still recurses, but it halves the range at
+ * each level, so the depth is log2(n / GRAIN): at most 64 levels for any
+ * range that fits in a size_t. The operator must be associative, so that
+ * (a + b) + c == a + (b + c) and the halves can be reduced independently;
+ * the engine keeps left-to-right order, so it need not be commutative.
+ *
+ * Usage: ./reduce [elements]   (default: 100000000, at least 1)
+ */
+
+#include <algorithm>  // For min/max
+#include <atomic>     // For task completion flags
+#include <chrono>     // For timing the benchmark
+#include <condition_variable>  // For idle pool workers
+#include <cstdint>    // For int32_t/int64_t
+#include <cstdlib>    // For strtoul
+#include <deque>      // For the task queue
+#include <functional> // For plus and function
+#include <iostream>   // For input/output operations
+#include <mutex>      // For the task queue
+#include <numeric>    // For accumulate/reduce
+#include <optional>   // For sums that would overflow
+#include <random>     // For test data
+#include <thread>     // For pool workers
+#include <vector>     // For test data
+using namespace std;
+
+const size_t GRAIN = 16 * 1024;  // Smallest range worth its own leaf call
+
+/*
+ * Class: TaskPool
+ * Purpose: A fixed set of worker threads running queued tasks
+ * Threads are started once and reused by every reduction. A thread that
+ * waits for a task can help with runPending(), so nested waits never
+ * leave all workers blocked.
+ */
+class TaskPool {
+    private:
+        mutex lock;
+        condition_variable wake;
+        deque<function<void()>> tasks;
+        vector<thread> workers;
+        bool stopping = false;
+
+    public:
+        explicit TaskPool(size_t threads) {
+            for (size_t i = 0; i < max<size_t>(threads, 1); i++) {
+                workers.emplace_back([this] {
+                    unique_lock<mutex> guard(lock);
+                    while (true) {
+                        wake.wait(guard, [this] { return stopping || !tasks.empty(); });
+                        if (tasks.empty()) {
+                            return;  // Stopping, and nothing left to do
+                        }
+                        function<void()> task = move(tasks.front());
+                        tasks.pop_front();
+                        guard.unlock();
+                        task();
+                        guard.lock();
+                    }
+                });
+            }
+        }
+
+        ~TaskPool() {
+            {
+                lock_guard<mutex> guard(lock);
+                stopping = true;
+            }
+            wake.notify_all();
+            for (thread& worker : workers) {
+                worker.join();
+            }
+        }
+
+        void submit(function<void()> task) {
+            {
+                lock_guard<mutex> guard(lock);
+                tasks.push_back(move(task));
+            }
+            wake.notify_one();
+        }
+
+        // Runs one queued task on the calling thread; false if there was none
+        bool runPending() {
+            function<void()> task;
+            {
+                lock_guard<mutex> guard(lock);
+                if (tasks.empty()) {
+                    return false;
+                }
+                task = move(tasks.front());
+                tasks.pop_front();
+            }
+            task();
+            return true;
+        }
+};
+
+// The pool every reduction shares, started on first use
+TaskPool& reducePool() {
+    static TaskPool pool(max(1u, thread::hardware_concurrency()));
+    return pool;
+}
+
+/*
+ * Function: splitAndReduce
+ * Purpose: The recursive core of reduceRange. The first 'spawnLevels'
+ * levels submit the right half to the pool as a task; deeper levels
+ * recurse in the same thread. 'depth' is only used to show the bound in
+ * the demo.
+ */
+template <typename Acc, typename Leaf, typename Op>
+Acc splitAndReduce(size_t first, size_t last, int spawnLevels, Leaf& leaf, Op& op, int depth, int& maxDepth) {
+    maxDepth = max(maxDepth, depth);
+    if (last - first <= GRAIN) {
+        return leaf(first, last);
+    }
+    size_t middle = first + (last - first) / 2;
+    if (spawnLevels > 0) {
+        Acc right{};
+        int rightDepth = 0;
+        atomic<bool> rightDone(false);
+        reducePool().submit([&] {
+            right = splitAndReduce<Acc>(middle, last, spawnLevels - 1, leaf, op, depth + 1, rightDepth);
+            rightDone.store(true, memory_order_release);
+        });
+        Acc left = splitAndReduce<Acc>(first, middle, spawnLevels - 1, leaf, op, depth + 1, maxDepth);
+        // Help with queued work (perhaps our own right half) until it is done
+        while (!rightDone.load(memory_order_acquire)) {
+            if (!reducePool().runPending()) {
+                this_thread::yield();
+            }
+        }
+        maxDepth = max(maxDepth, rightDepth);
+        return op(left, right);
+    }
+    Acc left = splitAndReduce<Acc>(first, middle, 0, leaf, op, depth + 1, maxDepth);
+    return op(left, splitAndReduce<Acc>(middle, last, 0, leaf, op, depth + 1, maxDepth));
+}
+
+/*
+ * Function: reduceRange
+ * Purpose: Reduces the index range [first, last), split into about two
+ * tasks per thread for 'threads' threads; the tasks run on the shared
+ * pool (one worker per hardware thread) and the calling thread.
+ * leaf(a, b) reduces a sub-range sequentially; op(x, y) combines the
+ * results of two neighbouring sub-ranges (left, right). Returns identity
+ * for an empty range.
+ */
+template <typename Acc, typename Leaf, typename Op>
+Acc reduceRange(size_t first, size_t last, Acc identity, Leaf leaf, Op op,
+                size_t threads = thread::hardware_concurrency(), int* depthUsed = nullptr) {
+    int maxDepth = 0;
+    Acc result = identity;
+    if (last > first) {
+        // Spawning 2^levels tasks gives every thread about two of them
+        int levels = 0;
+        while ((size_t)1 << levels < 2 * max<size_t>(threads, 1) && levels < 16) levels++;
+        if (threads <= 1) levels = 0;
+        result = op(identity, splitAndReduce<Acc>(first, last, levels, leaf, op, 0, maxDepth));
+    }
+    if (depthUsed != nullptr) {
+        *depthUsed = maxDepth;
+    }
+    return result;
+}
+
+/*
+ * Function: parallelReduce
+ * Purpose: Reduces an array with any associative operator, e.g.
+ * parallelReduce(v.data(), v.size(), INT_MIN, [](int a, int b) { return max(a, b); })
+ * The leaf is a plain loop; the compiler vectorises it where it can.
+ */
+template <typename T, typename Op>
+T parallelReduce(const T* data, size_t n, T identity, Op op) {
+    auto leaf = [data, identity, &op](size_t a, size_t b) {
+        T acc = identity;
+        for (size_t i = a; i < b; i++) acc = op(acc, data[i]);
+        return acc;
+    };
+    return reduceRange(0, n, identity, leaf, op);
+}
+
+// Leaf kernel for parallelSum: 32-bit values into a 64-bit accumulator.
+// One leaf adds at most GRAIN values of 2^31, so it cannot overflow.
+inline int64_t sumLoop(const int32_t* data, size_t first, size_t last) {
+    int64_t acc = 0;
+    for (size_t i = first; i < last; i++) acc += data[i];
+    return acc;
+}
+
+int64_t baseSumLeaf(const int32_t* data, size_t first, size_t last) { return sumLoop(data, first, last); }
+
+__attribute__((target("avx2")))
+int64_t avx2SumLeaf(const int32_t* data, size_t first, size_t last) { return sumLoop(data, first, last); }
+
+bool cpuHasAVX2() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+const bool HAS_AVX2 = cpuHasAVX2();
+
+/*
+ * Function: parallelSum
+ * Purpose: Exact sum of 32-bit integers. The int64_t total only
+ * overflows beyond 2^32 maximal values (16 GB of input).
+ */
+int64_t parallelSum(const int32_t* data, size_t n, size_t threads = thread::hardware_concurrency()) {
+    auto leaf = [data](size_t a, size_t b) {
+        return HAS_AVX2 ? avx2SumLeaf(data, a, b) : baseSumLeaf(data, a, b);
+    };
+    return reduceRange<int64_t>(0, n, 0, leaf, plus<int64_t>(), threads);
+}
+
+/*
+ * Struct: CheckedSum
+ * Purpose: A 64-bit sum that remembers whether it ever overflowed
+ * __builtin_add_overflow adds and reports overflow in one instruction
+ * pair (add + jo), so checking costs little.
+ */
+struct CheckedSum {
+    int64_t value;
+    bool overflow;
+
+    CheckedSum operator+(const CheckedSum& other) const {
+        CheckedSum result;
+        result.overflow = __builtin_add_overflow(value, other.value, &result.value) ||
+                          overflow || other.overflow;
+        return result;
+    }
+};
+
+CheckedSum checkedSum(const int64_t* data, size_t n) {
+    auto leaf = [data](size_t a, size_t b) {
+        CheckedSum acc{0, false};
+        for (size_t i = a; i < b; i++) {
+            acc.overflow |= __builtin_add_overflow(acc.value, data[i], &acc.value);
+        }
+        return acc;
+    };
+    return reduceRange(0, n, CheckedSum{0, false}, leaf, plus<CheckedSum>());
+}
+
+// Largest x whose 1 + 2 + ... + x fits in int64_t: x (x + 1) / 2 < 2^63
+const int64_t MAX_SUM_TO = 4294967295;  // 2^32 - 1
+
+/*
+ * Function: sumTo
+ * Purpose: recursion.cpp's sum(x) = 1 + 2 + ... + x without deep
+ * recursion. Returns nullopt for x > MAX_SUM_TO, where the result would
+ * not fit in int64_t.
+ */
+optional<int64_t> sumTo(int64_t x, int* depthUsed = nullptr) {
+    if (x > MAX_SUM_TO) {
+        return nullopt;
+    }
+    auto leaf = [](size_t a, size_t b) {
+        int64_t acc = 0;
+        for (size_t i = a; i < b; i++) acc += (int64_t)i;
+        return acc;
+    };
+    return reduceRange<int64_t>(1, (size_t)max<int64_t>(x, 0) + 1, 0, leaf, plus<int64_t>(),
+                                thread::hardware_concurrency(), depthUsed);
+}
+
+// sum() from recursion.cpp
+int sum(int x) {
+
+    if (x > 0) {
+        return x + sum(x - 1);
+    } else {
+        return 0;
+    }
+
+}
+
+// The same one-call-per-element recursion over an array. Sibling-call
+// optimisation is off so that GCC keeps the recursion instead of turning
+// it into a loop, as it would for this simple case.
+__attribute__((optimize("no-optimize-sibling-calls")))
+int64_t sumRecursive(const int32_t* data, size_t n) {
+    if (n == 0) {
+        return 0;
+    }
+    return data[n - 1] + sumRecursive(data, n - 1);
+}
+
+template <typename F>
+double nsPerElement(size_t n, F f, int64_t& result) {
+    double best = 1e30;
+    for (int run = 0; run < 3; run++) {
+        auto start = chrono::steady_clock::now();
+        result = f();
+        best = min(best, chrono::duration<double, nano>(chrono::steady_clock::now() - start).count());
+    }
+    return best / n;
+}
+
+void benchmark(size_t n) {
+    vector<int32_t> data(n);
+    mt19937 rng(5);
+    for (int32_t& v : data) v = (int32_t)rng();
+
+    cout << "Summing " << n << " random int32 values (ns per element, "
+         << thread::hardware_concurrency() << " hardware threads, "
+         << (HAS_AVX2 ? "AVX2" : "SSE2") << " leaves):" << endl;
+
+    int64_t expected, result;
+    size_t small = min<size_t>(n, 100000);  // One stack frame per element
+    double recursive = nsPerElement(small, [&] { return sumRecursive(data.data(), small); }, result);
+    cout << "  recursion, one call per element: " << recursive << "  (first " << small << " only)" << endl;
+
+    double accumulateTime = nsPerElement(n, [&] { return accumulate(data.begin(), data.end(), (int64_t)0); }, expected);
+    cout << "  std::accumulate:                 " << accumulateTime << endl;
+
+    // The explicit plus<int64_t> matters: with the default plus<>, reduce may
+    // add two int32 elements to each other first, in int, and overflow
+    double reduceTime = nsPerElement(n, [&] {
+        return reduce(data.begin(), data.end(), (int64_t)0, plus<int64_t>());
+    }, result);
+    cout << "  std::reduce:                     " << reduceTime << (result == expected ? "" : "  WRONG") << endl;
+
+    double oneThread = nsPerElement(n, [&] { return parallelSum(data.data(), n, 1); }, result);
+    cout << "  parallelSum, 1 thread:           " << oneThread << (result == expected ? "" : "  WRONG") << endl;
+
+    double allThreads = nsPerElement(n, [&] { return parallelSum(data.data(), n); }, result);
+    cout << "  parallelSum, all threads:        " << allThreads << (result == expected ? "" : "  WRONG") << endl;
+
+    int32_t biggest = parallelReduce(data.data(), n, INT32_MIN, [](int32_t a, int32_t b) { return max(a, b); });
+    cout << "  (largest value via parallelReduce: " << biggest
+         << (biggest == *max_element(data.begin(), data.end()) ? "" : "  WRONG") << ")" << endl;
+}
+
+int main(int argc, char* argv[]) {
+
+    int x = 10;
+    cout << "sum(" << x << ") from recursion.cpp: " << sum(x) << endl;
+
+    int depth = 0;
+    cout << "sumTo(10):            " << *sumTo(10, &depth) << "  (depth " << depth << ")" << endl;
+    int64_t total = *sumTo(100000, &depth);
+    cout << "sumTo(100000):        " << total << "  (depth " << depth << ", int would hold at most "
+         << INT32_MAX << ")" << endl;
+    total = *sumTo(1000000000, &depth);
+    cout << "sumTo(1000000000):    " << total << "  (depth " << depth << ")" << endl;
+    cout << "sumTo(" << MAX_SUM_TO + 1 << "): " << (sumTo(MAX_SUM_TO + 1) ? "a number (BUG!)" : "rejected, would overflow int64_t")
+         << endl;
+
+    vector<int64_t> big(1000, INT64_MAX / 500);
+    CheckedSum checked = checkedSum(big.data(), big.size());
+    cout << "Checked sum of 1000 x INT64_MAX/500: " << (checked.overflow ? "overflow detected" : "no overflow") << endl;
+    checked = checkedSum(big.data(), 400);
+    cout << "Checked sum of 400 of them:          " << checked.value
+         << (checked.overflow ? " (overflow)" : " (no overflow)") << endl << endl;
+
+    size_t n = 100000000;
+    if (argc > 1) {
+        n = max<size_t>(strtoul(argv[1], nullptr, 10), 1);  // Per-element times need elements
+    }
+    benchmark(n);
+
+    /*
+     * Key Learning Points:
+     * 1. One recursive call per element costs a stack frame per element
+     * 2. Halving the range keeps the recursion depth logarithmic
+     * 3. Associative operators let independent halves run in parallel
+     * 4. Large leaves let the compiler vectorise the inner loop
+     * 5. Widen or check accumulators: sums overflow long before the data does
+     */
+
+    return 0;
+}
@@ -0,0 +1,548 @@
+/*
+ * C++ Vectorised Pixel Buffer Examples
+ * ====================================
+ *
+ * RGB.cpp uses the RGB enum only to print colour names. In image code the
+ * same enum is the channel index of every pixel: pixel[RED], pixel[GREEN],
+ * pixel[BLUE]. This file demonstrates an image buffer module with kernels
+ * over whole frames:
+ * - toPlanar / toInterleaved: RGBRGBRGB... <-> RRR... GGG... BBB...
+ * - extractChannel: one channel (chosen by the RGB enum) into its own plane
+ * - grayscale: Y = (77 R + 150 G + 29 B) / 256
+ * - histogram: 256 bins per channel
+ * Each kernel has a scalar version (a plain per-pixel loop), an SSSE3
+ * version (16 pixels per step) and an AVX2 version (32 pixels per step),
+ * picked at startup like the kernels in string_scan.cpp.
+ *
+ * Concept: Interleaved pixels are awkward for SIMD: a register of 16 bytes
+ * holds 5 1/3 pixels. The byte shuffle instruction pshufb (SSSE3) can put
+ * any byte of a register anywhere, so three loads (48 bytes = 16 pixels)
+ * and nine shuffles sort them into 16 reds, 16 greens and 16 blues; the
+ * reverse gathers planes back into pixels. AVX2 shuffles within each
+ * 128-bit half, so each half is loaded with its own group of 16 pixels.
+ *
+ * Usage: ./pixels [frames]   (default: 20)
+ */
+
+#include <chrono>       // For timing the benchmark
+#include <cstdint>      // For uint8_t/uint32_t
+#include <cstdlib>      // For strtoul
+#include <cstring>      // For memcmp/memset
+#include <iostream>     // For input/output operations
+#include <random>       // For test images
+#include <vector>       // For pixel storage and the kernel list
+#include <immintrin.h>  // For SSE/AVX2 intrinsics
+using namespace std;
+
+// RGB from RGB.cpp: here also the byte offset of a channel in a pixel
+enum RGB {
+    RED,    // Byte 0 of each pixel
+    GREEN,  // Byte 1
+    BLUE    // Byte 2
+};
+
+const int CHANNELS = 3;
+
+/*
+ * Struct: PixelKernels
+ * Purpose: One complete set of kernels for a given instruction set
+ * 'rgb' is interleaved 8-bit RGB; 'planes' is indexed by the RGB enum.
+ */
+struct PixelKernels {
+    const char* name;
+    void (*toPlanar)(const uint8_t* rgb, size_t pixels, uint8_t* const planes[CHANNELS]);
+    void (*toInterleaved)(const uint8_t* const planes[CHANNELS], size_t pixels, uint8_t* rgb);
+    void (*extractChannel)(const uint8_t* rgb, size_t pixels, RGB channel, uint8_t* out);
+    void (*grayscale)(const uint8_t* rgb, size_t pixels, uint8_t* gray);
+    void (*histogram)(const uint8_t* rgb, size_t pixels, uint32_t counts[CHANNELS][256]);
+};
+
+// ---------------------------------------------------------------------
+// Scalar versions: the straightforward per-pixel loops
+// ---------------------------------------------------------------------
+
+uint8_t grayOf(uint8_t r, uint8_t g, uint8_t b) {
+    return (uint8_t)((77 * r + 150 * g + 29 * b + 128) >> 8);
+}
+
+void toPlanarScalar(const uint8_t* rgb, size_t pixels, uint8_t* const planes[CHANNELS]) {
+    for (size_t i = 0; i < pixels; i++) {
+        const uint8_t* pixel = rgb + 3 * i;
+        planes[RED][i] = pixel[RED];
+        planes[GREEN][i] = pixel[GREEN];
+        planes[BLUE][i] = pixel[BLUE];
+    }
+}
+
+void toInterleavedScalar(const uint8_t* const planes[CHANNELS], size_t pixels, uint8_t* rgb) {
+    for (size_t i = 0; i < pixels; i++) {
+        uint8_t* pixel = rgb + 3 * i;
+        pixel[RED] = planes[RED][i];
+        pixel[GREEN] = planes[GREEN][i];
+        pixel[BLUE] = planes[BLUE][i];
+    }
+}
+
+void extractChannelScalar(const uint8_t* rgb, size_t pixels, RGB channel, uint8_t* out) {
+    for (size_t i = 0; i < pixels; i++) {
+        out[i] = rgb[3 * i + channel];
+    }
+}
+
+void grayscaleScalar(const uint8_t* rgb, size_t pixels, uint8_t* gray) {
+    for (size_t i = 0; i < pixels; i++) {
+        const uint8_t* pixel = rgb + 3 * i;
+        gray[i] = grayOf(pixel[RED], pixel[GREEN], pixel[BLUE]);
+    }
+}
+
+void histogramScalar(const uint8_t* rgb, size_t pixels, uint32_t counts[CHANNELS][256]) {
+    memset(counts, 0, sizeof(uint32_t) * CHANNELS * 256);
+    for (size_t i = 0; i < pixels; i++) {
+        const uint8_t* pixel = rgb + 3 * i;
+        counts[RED][pixel[RED]]++;
+        counts[GREEN][pixel[GREEN]]++;
+        counts[BLUE][pixel[BLUE]]++;
+    }
+}
+
+// ---------------------------------------------------------------------
+// Shuffle tables: 16-byte pshufb masks (0x80 = "put a zero here")
+// ---------------------------------------------------------------------
+
+struct ShuffleMasks {
+    // DEINTERLEAVE[c][k]: bytes of channel c found in input register k
+    alignas(16) uint8_t deinterleave[CHANNELS][3][16];
+    // INTERLEAVE[k][c]: bytes of output register k taken from channel c
+    alignas(16) uint8_t interleave[3][CHANNELS][16];
+};
+
+ShuffleMasks buildMasks() {
+    ShuffleMasks m;
+    for (int c = 0; c < CHANNELS; c++) {
+        for (int k = 0; k < 3; k++) {
+            for (int i = 0; i < 16; i++) {
+                int source = 3 * i + c;  // Byte of pixel i, channel c, in 48 bytes
+                m.deinterleave[c][k][i] = source / 16 == k ? (uint8_t)(source % 16) : 0x80;
+                int target = 16 * k + i;  // Output byte: pixel target / 3, channel target % 3
+                m.interleave[k][c][i] = target % 3 == c ? (uint8_t)(target / 3) : 0x80;
+            }
+        }
+    }
+    return m;
+}
+
+const ShuffleMasks MASKS = buildMasks();
+
+// ---------------------------------------------------------------------
+// SSSE3 versions: 16 pixels (48 bytes) per step
+// ---------------------------------------------------------------------
+
+__attribute__((target("ssse3")))
+inline __m128i gatherChannel128(__m128i a, __m128i b, __m128i c, int channel) {
+    const __m128i* mask = (const __m128i*)MASKS.deinterleave[channel];
+    return _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a, _mm_load_si128(mask)),
+                                     _mm_shuffle_epi8(b, _mm_load_si128(mask + 1))),
+                        _mm_shuffle_epi8(c, _mm_load_si128(mask + 2)));
+}
+
+__attribute__((target("ssse3")))
+inline __m128i scatterRegister128(__m128i r, __m128i g, __m128i b, int k) {
+    const __m128i* mask = (const __m128i*)MASKS.interleave[k];
+    return _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(r, _mm_load_si128(mask + RED)),
+                                     _mm_shuffle_epi8(g, _mm_load_si128(mask + GREEN))),
+                        _mm_shuffle_epi8(b, _mm_load_si128(mask + BLUE)));
+}
+
+__attribute__((target("ssse3")))
+inline __m128i gray128(__m128i r, __m128i g, __m128i b) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i halves[2];
+    for (int h = 0; h < 2; h++) {
+        __m128i r16 = h == 0 ? _mm_unpacklo_epi8(r, zero) : _mm_unpackhi_epi8(r, zero);
+        __m128i g16 = h == 0 ? _mm_unpacklo_epi8(g, zero) : _mm_unpackhi_epi8(g, zero);
+        __m128i b16 = h == 0 ? _mm_unpacklo_epi8(b, zero) : _mm_unpackhi_epi8(b, zero);
+        __m128i sum = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(r16, _mm_set1_epi16(77)),
+                                                  _mm_mullo_epi16(g16, _mm_set1_epi16(150))),
+                                    _mm_add_epi16(_mm_mullo_epi16(b16, _mm_set1_epi16(29)),
+                                                  _mm_set1_epi16(128)));
+        halves[h] = _mm_srli_epi16(sum, 8);  // Largest sum is 65408: fits unsigned 16 bits
+    }
+    return _mm_packus_epi16(halves[0], halves[1]);
+}
+
+__attribute__((target("ssse3")))
+void toPlanarSSSE3(const uint8_t* rgb, size_t pixels, uint8_t* const planes[CHANNELS]) {
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16) {
+        const __m128i* p = (const __m128i*)(rgb + 3 * i);
+        __m128i a = _mm_loadu_si128(p), b = _mm_loadu_si128(p + 1), c = _mm_loadu_si128(p + 2);
+        for (int ch = 0; ch < CHANNELS; ch++) {
+            _mm_storeu_si128((__m128i*)(planes[ch] + i), gatherChannel128(a, b, c, ch));
+        }
+    }
+    uint8_t* const rest[CHANNELS] = {planes[RED] + i, planes[GREEN] + i, planes[BLUE] + i};
+    toPlanarScalar(rgb + 3 * i, pixels - i, rest);
+}
+
+__attribute__((target("ssse3")))
+void toInterleavedSSSE3(const uint8_t* const planes[CHANNELS], size_t pixels, uint8_t* rgb) {
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16) {
+        __m128i r = _mm_loadu_si128((const __m128i*)(planes[RED] + i));
+        __m128i g = _mm_loadu_si128((const __m128i*)(planes[GREEN] + i));
+        __m128i b = _mm_loadu_si128((const __m128i*)(planes[BLUE] + i));
+        __m128i* out = (__m128i*)(rgb + 3 * i);
+        for (int k = 0; k < 3; k++) {
+            _mm_storeu_si128(out + k, scatterRegister128(r, g, b, k));
+        }
+    }
+    const uint8_t* const rest[CHANNELS] = {planes[RED] + i, planes[GREEN] + i, planes[BLUE] + i};
+    toInterleavedScalar(rest, pixels - i, rgb + 3 * i);
+}
+
+__attribute__((target("ssse3")))
+void extractChannelSSSE3(const uint8_t* rgb, size_t pixels, RGB channel, uint8_t* out) {
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16) {
+        const __m128i* p = (const __m128i*)(rgb + 3 * i);
+        __m128i a = _mm_loadu_si128(p), b = _mm_loadu_si128(p + 1), c = _mm_loadu_si128(p + 2);
+        _mm_storeu_si128((__m128i*)(out + i), gatherChannel128(a, b, c, channel));
+    }
+    extractChannelScalar(rgb + 3 * i, pixels - i, channel, out + i);
+}
+
+__attribute__((target("ssse3")))
+void grayscaleSSSE3(const uint8_t* rgb, size_t pixels, uint8_t* gray) {
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16) {
+        const __m128i* p = (const __m128i*)(rgb + 3 * i);
+        __m128i a = _mm_loadu_si128(p), b = _mm_loadu_si128(p + 1), c = _mm_loadu_si128(p + 2);
+        __m128i y = gray128(gatherChannel128(a, b, c, RED), gatherChannel128(a, b, c, GREEN),
+                            gatherChannel128(a, b, c, BLUE));
+        _mm_storeu_si128((__m128i*)(gray + i), y);
+    }
+    grayscaleScalar(rgb + 3 * i, pixels - i, gray + i);
+}
+
+/*
+ * Histogram: scattered "counts[value]++" cannot be vectorised on SSE or
+ * AVX2 (two lanes hitting the same bin would lose an increment). The fast
+ * version instead keeps four copies of every table and sends neighbouring
+ * pixels to different copies: in flat image areas, neighbours usually
+ * have the same value, and one copy would make each increment wait for
+ * the previous one to reach memory. The copies are added up at the end.
+ */
+inline void histogramReplicated(const uint8_t* rgb, size_t pixels, uint32_t counts[CHANNELS][256]) {
+    static thread_local uint32_t copies[4][CHANNELS][256];
+    memset(copies, 0, sizeof(copies));
+    size_t i = 0;
+    for (; i + 4 <= pixels; i += 4) {
+        const uint8_t* p = rgb + 3 * i;
+        for (int k = 0; k < 4; k++) {
+            copies[k][RED][p[3 * k + RED]]++;
+            copies[k][GREEN][p[3 * k + GREEN]]++;
+            copies[k][BLUE][p[3 * k + BLUE]]++;
+        }
+    }
+    for (; i < pixels; i++) {
+        const uint8_t* p = rgb + 3 * i;
+        copies[0][RED][p[RED]]++;
+        copies[0][GREEN][p[GREEN]]++;
+        copies[0][BLUE][p[BLUE]]++;
+    }
+    for (int c = 0; c < CHANNELS; c++) {
+        for (int v = 0; v < 256; v++) {
+            counts[c][v] = copies[0][c][v] + copies[1][c][v] + copies[2][c][v] + copies[3][c][v];
+        }
+    }
+}
+
+__attribute__((target("ssse3")))
+void histogramSSSE3(const uint8_t* rgb, size_t pixels, uint32_t counts[CHANNELS][256]) {
+    histogramReplicated(rgb, pixels, counts);
+}
+
+// ---------------------------------------------------------------------
+// AVX2 versions: 32 pixels (96 bytes) per step
+// vpshufb works inside each 128-bit half, so the low half of every
+// register holds pixels 0..15 and the high half pixels 16..31.
+// ---------------------------------------------------------------------
+
+__attribute__((target("avx2")))
+inline void load96(const uint8_t* p, __m256i& a, __m256i& b, __m256i& c) {
+    const __m128i* q = (const __m128i*)p;
+    a = _mm256_set_m128i(_mm_loadu_si128(q + 3), _mm_loadu_si128(q));
+    b = _mm256_set_m128i(_mm_loadu_si128(q + 4), _mm_loadu_si128(q + 1));
+    c = _mm256_set_m128i(_mm_loadu_si128(q + 5), _mm_loadu_si128(q + 2));
+}
+
+__attribute__((target("avx2")))
+inline __m256i mask256(const uint8_t* mask16) {
+    return _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)mask16));
+}
+
+__attribute__((target("avx2")))
+inline __m256i gatherChannel256(__m256i a, __m256i b, __m256i c, int channel) {
+    return _mm256_or_si256(_mm256_or_si256(_mm256_shuffle_epi8(a, mask256(MASKS.deinterleave[channel][0])),
+                                           _mm256_shuffle_epi8(b, mask256(MASKS.deinterleave[channel][1]))),
+                           _mm256_shuffle_epi8(c, mask256(MASKS.deinterleave[channel][2])));
+}
+
+__attribute__((target("avx2")))
+inline __m256i scatterRegister256(__m256i r, __m256i g, __m256i b, int k) {
+    return _mm256_or_si256(_mm256_or_si256(_mm256_shuffle_epi8(r, mask256(MASKS.interleave[k][RED])),
+                                           _mm256_shuffle_epi8(g, mask256(MASKS.interleave[k][GREEN]))),
+                           _mm256_shuffle_epi8(b, mask256(MASKS.interleave[k][BLUE])));
+}
+
+__attribute__((target("avx2")))
+void toPlanarAVX2(const uint8_t* rgb, size_t pixels, uint8_t* const planes[CHANNELS]) {
+    size_t i = 0;
+    for (; i + 32 <= pixels; i += 32) {
+        __m256i a, b, c;
+        load96(rgb + 3 * i, a, b, c);
+        for (int ch = 0; ch < CHANNELS; ch++) {
+            _mm256_storeu_si256((__m256i*)(planes[ch] + i), gatherChannel256(a, b, c, ch));
+        }
+    }
+    uint8_t* const rest[CHANNELS] = {planes[RED] + i, planes[GREEN] + i, planes[BLUE] + i};
+    toPlanarSSSE3(rgb + 3 * i, pixels - i, rest);
+}
+
+__attribute__((target("avx2")))
+void toInterleavedAVX2(const uint8_t* const planes[CHANNELS], size_t pixels, uint8_t* rgb) {
+    size_t i = 0;
+    for (; i + 32 <= pixels; i += 32) {
+        __m256i r = _mm256_loadu_si256((const __m256i*)(planes[RED] + i));
+        __m256i g = _mm256_loadu_si256((const __m256i*)(planes[GREEN] + i));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(planes[BLUE] + i));
+        __m256i out0 = scatterRegister256(r, g, b, 0);
+        __m256i out1 = scatterRegister256(r, g, b, 1);
+        __m256i out2 = scatterRegister256(r, g, b, 2);
+        // Low halves are bytes 0..47, high halves bytes 48..95
+        __m256i* out = (__m256i*)(rgb + 3 * i);
+        _mm256_storeu_si256(out, _mm256_permute2x128_si256(out0, out1, 0x20));
+        _mm256_storeu_si256(out + 1, _mm256_permute2x128_si256(out2, out0, 0x30));
+        _mm256_storeu_si256(out + 2, _mm256_permute2x128_si256(out1, out2, 0x31));
+    }
+    const uint8_t* const rest[CHANNELS] = {planes[RED] + i, planes[GREEN] + i, planes[BLUE] + i};
+    toInterleavedSSSE3(rest, pixels - i, rgb + 3 * i);
+}
+
+__attribute__((target("avx2")))
+void extractChannelAVX2(const uint8_t* rgb, size_t pixels, RGB channel, uint8_t* out) {
+    size_t i = 0;
+    for (; i + 32 <= pixels; i += 32) {
+        __m256i a, b, c;
+        load96(rgb + 3 * i, a, b, c);
+        _mm256_storeu_si256((__m256i*)(out + i), gatherChannel256(a, b, c, channel));
+    }
+    extractChannelSSSE3(rgb + 3 * i, pixels - i, channel, out + i);
+}
+
+__attribute__((target("avx2")))
+void grayscaleAVX2(const uint8_t* rgb, size_t pixels, uint8_t* gray) {
+    const __m256i zero = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 32 <= pixels; i += 32) {
+        __m256i a, b, c;
+        load96(rgb + 3 * i, a, b, c);
+        __m256i r = gatherChannel256(a, b, c, RED);
+        __m256i g = gatherChannel256(a, b, c, GREEN);
+        __m256i bl = gatherChannel256(a, b, c, BLUE);
+        // unpack and packus also work per half, so pixel order is kept
+        __m256i halves[2];
+        for (int h = 0; h < 2; h++) {
+            __m256i r16 = h == 0 ? _mm256_unpacklo_epi8(r, zero) : _mm256_unpackhi_epi8(r, zero);
+            __m256i g16 = h == 0 ? _mm256_unpacklo_epi8(g, zero) : _mm256_unpackhi_epi8(g, zero);
+            __m256i b16 = h == 0 ? _mm256_unpacklo_epi8(bl, zero) : _mm256_unpackhi_epi8(bl, zero);
+            __m256i sum = _mm256_add_epi16(
+                _mm256_add_epi16(_mm256_mullo_epi16(r16, _mm256_set1_epi16(77)),
+                                 _mm256_mullo_epi16(g16, _mm256_set1_epi16(150))),
+                _mm256_add_epi16(_mm256_mullo_epi16(b16, _mm256_set1_epi16(29)), _mm256_set1_epi16(128)));
+            halves[h] = _mm256_srli_epi16(sum, 8);
+        }
+        _mm256_storeu_si256((__m256i*)(gray + i), _mm256_packus_epi16(halves[0], halves[1]));
+    }
+    grayscaleSSSE3(rgb + 3 * i, pixels - i, gray + i);
+}
+
+__attribute__((target("avx2")))
+void histogramAVX2(const uint8_t* rgb, size_t pixels, uint32_t counts[CHANNELS][256]) {
+    histogramReplicated(rgb, pixels, counts);
+}
+
+// ---------------------------------------------------------------------
+// Runtime dispatch
+// ---------------------------------------------------------------------
+
+const PixelKernels SCALAR_KERNELS = {"scalar", toPlanarScalar, toInterleavedScalar,
+                                     extractChannelScalar, grayscaleScalar, histogramScalar};
+const PixelKernels SSSE3_KERNELS = {"SSSE3", toPlanarSSSE3, toInterleavedSSSE3,
+                                    extractChannelSSSE3, grayscaleSSSE3, histogramSSSE3};
+const PixelKernels AVX2_KERNELS = {"AVX2", toPlanarAVX2, toInterleavedAVX2,
+                                   extractChannelAVX2, grayscaleAVX2, histogramAVX2};
+
+// Every kernel set this CPU can run, slowest first
+vector<const PixelKernels*> supportedKernels() {
+    __builtin_cpu_init();
+    vector<const PixelKernels*> sets;
+    sets.push_back(&SCALAR_KERNELS);
+    if (__builtin_cpu_supports("ssse3")) {
+        sets.push_back(&SSSE3_KERNELS);
+        if (__builtin_cpu_supports("avx2")) {
+            sets.push_back(&AVX2_KERNELS);
+        }
+    }
+    return sets;
+}
+
+// The kernels everyone should call: chosen once, before main() runs
+const PixelKernels& pixelKernels = *supportedKernels().back();
+
+/*
+ * Class: RgbImage
+ * Purpose: An interleaved 8-bit RGB frame, addressed by (x, y, channel)
+ */
+class RgbImage {
+    private:
+        size_t w;
+        size_t h;
+        vector<uint8_t> bytes;
+
+    public:
+        RgbImage(size_t width, size_t height) : w(width), h(height), bytes(width * height * CHANNELS) {}
+
+        uint8_t& at(size_t x, size_t y, RGB channel) { return bytes[(y * w + x) * CHANNELS + channel]; }
+        size_t width() const { return w; }
+        size_t height() const { return h; }
+        size_t pixels() const { return w * h; }
+        uint8_t* data() { return bytes.data(); }
+        const uint8_t* data() const { return bytes.data(); }
+};
+
+// A smooth gradient with a little noise: like a photo, neighbouring
+// pixels are often equal
+RgbImage testImage(size_t width, size_t height, unsigned seed) {
+    RgbImage image(width, height);
+    mt19937 rng(seed);
+    for (size_t y = 0; y < height; y++) {
+        for (size_t x = 0; x < width; x++) {
+            image.at(x, y, RED) = (uint8_t)(x * 256 / width);
+            image.at(x, y, GREEN) = (uint8_t)(y * 256 / height);
+            image.at(x, y, BLUE) = (uint8_t)(128 + (rng() % 4));
+        }
+    }
+    return image;
+}
+
+/*
+ * Function: selfTest
+ * Purpose: Checks every kernel set against the scalar one on images
+ * whose sizes are not multiples of 16 or 32 (so tails are exercised)
+ */
+bool selfTest(const PixelKernels& k) {
+    mt19937 rng(7);
+    for (size_t pixels : {1, 15, 16, 31, 32, 33, 100, 1000, 4099}) {
+        RgbImage image(pixels, 1);
+        for (size_t i = 0; i < pixels * CHANNELS; i++) image.data()[i] = (uint8_t)rng();
+
+        vector<uint8_t> expected(pixels * CHANNELS), got(pixels * CHANNELS);
+        uint8_t* const e[CHANNELS] = {&expected[0], &expected[pixels], &expected[2 * pixels]};
+        uint8_t* const g[CHANNELS] = {&got[0], &got[pixels], &got[2 * pixels]};
+        SCALAR_KERNELS.toPlanar(image.data(), pixels, e);
+        k.toPlanar(image.data(), pixels, g);
+        if (expected != got) return false;
+
+        vector<uint8_t> back(pixels * CHANNELS);
+        k.toInterleaved(g, pixels, back.data());
+        if (memcmp(back.data(), image.data(), back.size()) != 0) return false;
+
+        for (RGB channel : {RED, GREEN, BLUE}) {
+            vector<uint8_t> plane(pixels);
+            k.extractChannel(image.data(), pixels, channel, plane.data());
+            if (memcmp(plane.data(), e[channel], pixels) != 0) return false;
+        }
+
+        vector<uint8_t> grayExpected(pixels), grayGot(pixels);
+        SCALAR_KERNELS.grayscale(image.data(), pixels, grayExpected.data());
+        k.grayscale(image.data(), pixels, grayGot.data());
+        if (grayExpected != grayGot) return false;
+
+        uint32_t histExpected[CHANNELS][256], histGot[CHANNELS][256];
+        SCALAR_KERNELS.histogram(image.data(), pixels, histExpected);
+        k.histogram(image.data(), pixels, histGot);
+        if (memcmp(histExpected, histGot, sizeof(histGot)) != 0) return false;
+    }
+    return true;
+}
+
+template <typename F>
+double megapixelsPerSecond(size_t pixels, size_t frames, F f) {
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < frames; i++) {
+        f();
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return pixels * frames / seconds / 1e6;
+}
+
+void benchmark(size_t frames, const vector<const PixelKernels*>& sets) {
+    RgbImage frame = testImage(3840, 2160, 1);
+    size_t pixels = frame.pixels();
+    vector<uint8_t> planeData(pixels * CHANNELS), out(pixels * CHANNELS);
+    uint8_t* const planes[CHANNELS] = {&planeData[0], &planeData[pixels], &planeData[2 * pixels]};
+    uint32_t counts[CHANNELS][256];
+
+    cout << "3840 x 2160 frame, " << frames << " frames (megapixels/s):" << endl;
+    cout << "  kernels\ttoPlanar\ttoInterleaved\textract(GREEN)\tgrayscale\thistogram" << endl;
+    for (const PixelKernels* k : sets) {
+        cout << "  " << k->name << "\t\t"
+             << megapixelsPerSecond(pixels, frames, [&] { k->toPlanar(frame.data(), pixels, planes); }) << "\t\t"
+             << megapixelsPerSecond(pixels, frames, [&] { k->toInterleaved(planes, pixels, out.data()); }) << "\t\t"
+             << megapixelsPerSecond(pixels, frames, [&] { k->extractChannel(frame.data(), pixels, GREEN, out.data()); })
+             << "\t\t"
+             << megapixelsPerSecond(pixels, frames, [&] { k->grayscale(frame.data(), pixels, out.data()); }) << "\t\t"
+             << megapixelsPerSecond(pixels, frames, [&] { k->histogram(frame.data(), pixels, counts); }) << endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+
+    vector<const PixelKernels*> sets = supportedKernels();
+    cout << "Using " << pixelKernels.name << " kernels" << endl;
+
+    // A 4 x 1 image: red, green, blue and white pixels
+    RgbImage tiny(4, 1);
+    const uint8_t colours[4][CHANNELS] = {{255, 0, 0}, {0, 255, 0}, {0, 0, 255}, {255, 255, 255}};
+    for (size_t x = 0; x < 4; x++) {
+        for (RGB channel : {RED, GREEN, BLUE}) tiny.at(x, 0, channel) = colours[x][channel];
+    }
+    uint8_t gray[4];
+    pixelKernels.grayscale(tiny.data(), 4, gray);
+    cout << "Grayscale of red, green, blue, white: " << (int)gray[0] << " " << (int)gray[1] << " "
+         << (int)gray[2] << " " << (int)gray[3] << endl;
+
+    for (const PixelKernels* k : sets) {
+        cout << "Self-test " << k->name << ": " << (selfTest(*k) ? "passed" : "FAILED") << endl;
+    }
+    cout << endl;
+
+    size_t frames = 20;
+    if (argc > 1) {
+        frames = strtoul(argv[1], nullptr, 10);
+    }
+    benchmark(frames, sets);
+
+    /*
+     * Key Learning Points:
+     * 1. An enum makes a readable, type-checked channel index
+     * 2. pshufb rearranges bytes freely inside a register
+     * 3. AVX2 shuffles work per 128-bit half; load data to match
+     * 4. Widen to 16 bits for weighted sums, then pack back to bytes
+     * 5. Histograms resist SIMD; several table copies still help
+     */
+
+    return 0;
+}
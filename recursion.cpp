@@ -1,7 +1,13 @@
 #include <iostream>
 using namespace std;
 
+// Probe for trace_examples.cpp; it does nothing unless trace.h is included first
+#ifndef TRACE_SCOPE
+#define TRACE_SCOPE(name) static_assert(true, "")
+#endif
+
 int sum(int x) {
+    TRACE_SCOPE("sum");
 
     if (x > 0) {
         return x + sum(x - 1);
@@ -0,0 +1,227 @@
+/*
+ * C++ Sharded Counter Examples
+ * ============================
+ *
+ * increment.cpp shows x++ and x-- on a local copy. Real counters (requests
+ * served, cars sold) are shared by many threads at once. This file shows:
+ * - Why one std::atomic<long> gets slow when many threads hit it
+ * - ShardedCounter: one counter per thread (or per CPU core), each on its
+ *   own 64-byte cache line, added up only when someone reads the total
+ * - ApproximateCounter: threads batch updates locally and publish them
+ *   every 'threshold' steps; read() is one load and is never off by more
+ *   than a known bound
+ * - A contention benchmark from 1 to 64 threads
+ *
+ * Concept: CPUs move memory between cores in 64-byte cache lines. If all
+ * threads increment the same atomic, that line bounces from core to core
+ * on every increment. Giving each thread its own line (and padding it so
+ * that neighbours do not share a line, "false sharing") removes the
+ * bouncing; the price is a slower read that has to visit every shard.
+ *
+ * Usage: ./counter [total increments] [max threads]   (default: 16000000 64)
+ */
+
+#include <algorithm>  // For min
+#include <atomic>     // For atomic counters
+#include <chrono>     // For timing the benchmark
+#include <cstdlib>    // For strtoul/labs
+#include <iostream>   // For input/output operations
+#include <thread>     // For worker threads
+#include <vector>     // For the thread list
+#include <sched.h>    // For sched_getcpu()
+using namespace std;
+
+const size_t CACHE_LINE = 64;
+const size_t SHARDS = 64;  // Power of two, at least the expected thread count
+
+// One counter alone on its cache line
+struct alignas(CACHE_LINE) PaddedCounter {
+    atomic<long> value;
+    PaddedCounter() : value(0) {}
+};
+
+// Each thread gets a small id the first time it touches any counter
+atomic<size_t> nextThreadSlot(0);
+thread_local size_t threadSlot = nextThreadSlot++ % SHARDS;
+
+enum ShardBy {
+    BY_THREAD,  // Shard chosen once per thread: no system call per update
+    BY_CPU      // Shard of the core we are running on right now
+};
+
+/*
+ * Class: ShardedCounter
+ * Purpose: An exact counter with cheap, contention-free updates
+ * Updates use memory_order_relaxed: we only need the count itself to be
+ * correct, not to order other memory operations around it.
+ */
+class ShardedCounter {
+    private:
+        PaddedCounter shards[SHARDS];
+        ShardBy mode;
+
+        PaddedCounter& mine() {
+            size_t slot = mode == BY_CPU ? (size_t)sched_getcpu() : threadSlot;
+            return shards[slot % SHARDS];
+        }
+
+    public:
+        explicit ShardedCounter(ShardBy by = BY_THREAD) : mode(by) {}
+
+        void increment() { mine().value.fetch_add(1, memory_order_relaxed); }
+        void decrement() { mine().value.fetch_sub(1, memory_order_relaxed); }
+        void add(long delta) { mine().value.fetch_add(delta, memory_order_relaxed); }
+
+        // Adds up all shards. Concurrent updates may or may not be included.
+        long read() const {
+            long total = 0;
+            for (const PaddedCounter& shard : shards) {
+                total += shard.value.load(memory_order_relaxed);
+            }
+            return total;
+        }
+};
+
+/*
+ * Class: ApproximateCounter
+ * Purpose: A counter whose read() is a single load, at bounded staleness
+ * Each thread keeps a pending amount in its own padded slot (slots are
+ * still atomic, so more threads than slots stay correct). Once that amount
+ * reaches +/- threshold it is moved to the shared total, which is only
+ * written once per 'threshold' updates. So read() can miss at most
+ * (threshold - 1) per slot:
+ *     |read() - true count| <= SHARDS * (threshold - 1)
+ * (with up to SHARDS live threads, so that no two share a slot).
+ * flush() publishes the calling thread's pending amount immediately.
+ */
+class ApproximateCounter {
+    private:
+        PaddedCounter total;
+        PaddedCounter pending[SHARDS];  // Usually touched by one thread only
+        long threshold;
+
+    public:
+        explicit ApproximateCounter(long limit) : threshold(limit) {}
+
+        void add(long delta) {
+            atomic<long>& local = pending[threadSlot].value;
+            long value = local.fetch_add(delta, memory_order_relaxed) + delta;
+            if (labs(value) >= threshold) {
+                // Publish whatever is pending now (another thread sharing
+                // this slot may have added to it in the meantime)
+                total.value.fetch_add(local.exchange(0, memory_order_relaxed), memory_order_relaxed);
+            }
+        }
+
+        void increment() { add(1); }
+        void decrement() { add(-1); }
+
+        void flush() {
+            long value = pending[threadSlot].value.exchange(0, memory_order_relaxed);
+            total.value.fetch_add(value, memory_order_relaxed);
+        }
+
+        long read() const { return total.value.load(memory_order_relaxed); }
+        long maxError() const { return (long)SHARDS * (threshold - 1); }
+};
+
+// increment() and decrement() from increment.cpp, now on a shared counter
+void increment(ShardedCounter& counter) {
+    counter.increment();
+}
+
+void decrement(ShardedCounter& counter) {
+    counter.decrement();
+}
+
+/*
+ * Function: run
+ * Purpose: Starts 'threads' threads that together perform 'total'
+ * updates through 'work', and returns millions of updates per second.
+ */
+template <typename Work>
+double run(size_t threads, size_t total, Work work) {
+    size_t each = total / threads;
+    auto start = chrono::steady_clock::now();
+    vector<thread> pool;
+    for (size_t t = 0; t < threads; t++) {
+        pool.emplace_back([each, &work] {
+            for (size_t i = 0; i < each; i++) {
+                work();
+            }
+        });
+    }
+    for (thread& t : pool) {
+        t.join();
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return each * threads / seconds / 1e6;
+}
+
+void benchmark(size_t total, size_t maxThreads) {
+    cout << "Increments per second (millions), " << total << " increments, "
+         << thread::hardware_concurrency() << " hardware threads:" << endl;
+    cout << "  threads\tatomic\tsharded\tper-CPU\tapprox" << endl;
+
+    for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+        atomic<long> single(0);
+        ShardedCounter byThread(BY_THREAD);
+        ShardedCounter byCpu(BY_CPU);
+        ApproximateCounter approx(1024);
+
+        double a = run(threads, total, [&single] { single.fetch_add(1, memory_order_relaxed); });
+        double b = run(threads, total, [&byThread] { byThread.increment(); });
+        double c = run(threads, total, [&byCpu] { byCpu.increment(); });
+        double d = run(threads, total, [&approx] { approx.increment(); });
+
+        long expected = (long)(total / threads * threads);
+        bool exact = single.load() == expected && byThread.read() == expected && byCpu.read() == expected;
+        bool bounded = labs(approx.read() - expected) <= approx.maxError();
+        cout << "  " << threads << "\t\t" << a << "\t" << b << "\t" << c << "\t" << d
+             << (exact && bounded ? "" : "\tWRONG COUNT") << endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+
+    ShardedCounter x;
+    x.add(3);
+    cout << "Original value of X: " << x.read() << endl;
+
+    // Two threads update the same counter at the same time
+    thread up([&x] { for (int i = 0; i < 100000; i++) increment(x); });
+    thread down([&x] { for (int i = 0; i < 40000; i++) decrement(x); });
+    up.join();
+    down.join();
+    cout << "After 100000 increments and 40000 decrements: " << x.read() << endl;
+
+    ApproximateCounter sold(100);
+    for (int i = 0; i < 250; i++) {
+        sold.increment();
+    }
+    cout << "Approximate count after 250 increments: " << sold.read()
+         << " (error bound " << sold.maxError() << ")" << endl;
+    sold.flush();
+    cout << "After flush(): " << sold.read() << endl << endl;
+
+    size_t total = 16000000;
+    size_t maxThreads = 64;
+    if (argc > 1) {
+        total = strtoul(argv[1], nullptr, 10);
+    }
+    if (argc > 2) {
+        maxThreads = strtoul(argv[2], nullptr, 10);
+    }
+    benchmark(total, maxThreads);
+
+    /*
+     * Key Learning Points:
+     * 1. Atomic operations are correct across threads but not free
+     * 2. A single hot cache line serialises all cores ("contention")
+     * 3. alignas(64) keeps each shard on its own line (no false sharing)
+     * 4. Sharding makes writes cheap and reads more expensive
+     * 5. Allowing a bounded error makes both reads and writes cheap
+     */
+
+    return 0;
+}
@@ -0,0 +1,214 @@
+/*
+ * C++ String Builder Examples
+ * ===========================
+ *
+ * This file demonstrates building a string from many pieces cheaply:
+ * - name() from strngs.cpp and modifyStr() from functions.cpp rebuilt
+ *   with a StringBuilder
+ * - StringBuilder remembers pieces as string_views (no copying yet)
+ * - build() allocates the result once, at its final size, and copies
+ *   every piece exactly once
+ * - A benchmark that counts heap allocations by replacing operator new
+ *
+ * Concept: s += piece has to grow s whenever it runs out of capacity;
+ * growing means allocating a bigger block and copying everything so far.
+ * a + b + c also makes temporary strings. Knowing the total length up
+ * front removes both costs.
+ *
+ * Usage: ./builder [builds]   (default: 1000000)
+ */
+
+#include <atomic>       // For the allocation counter
+#include <chrono>       // For timing the benchmark
+#include <cstdlib>      // For malloc/free/strtoul
+#include <cstring>      // For memcpy
+#include <iostream>     // For input/output operations
+#include <new>          // For replacing operator new/delete
+#include <string>       // For string class
+#include <string_view>  // For non-owning pieces
+#include <vector>       // For the piece list
+using namespace std;
+
+// Every heap allocation in this program goes through these two functions
+atomic<size_t> allocations(0);
+
+void* operator new(size_t size) {
+    allocations.fetch_add(1, memory_order_relaxed);
+    void* p = malloc(size == 0 ? 1 : size);
+    if (p == nullptr) {
+        throw bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
+/*
+ * Class: StringBuilder
+ * Purpose: Collects string pieces and joins them with one allocation
+ * Pieces are stored as views, so the text they point at must stay alive
+ * until build() is called (string literals and existing strings are fine).
+ * clear() keeps the piece list's capacity, so a reused builder does not
+ * allocate at all apart from the final string.
+ */
+class StringBuilder {
+    private:
+        vector<string_view> pieces;
+        size_t total;
+
+    public:
+        StringBuilder() : total(0) {}
+        explicit StringBuilder(size_t expectedPieces) : total(0) {
+            pieces.reserve(expectedPieces);
+        }
+
+        StringBuilder& append(string_view piece) {
+            pieces.push_back(piece);
+            total += piece.size();
+            return *this;
+        }
+
+        StringBuilder& operator<<(string_view piece) {
+            return append(piece);
+        }
+
+        size_t length() const { return total; }
+        void clear() { pieces.clear(); total = 0; }
+
+        string build() const;
+        void buildInto(string& out) const;
+};
+
+/*
+ * Function: StringBuilder::build
+ * Purpose: Returns the joined string: one allocation, one copy per piece
+ */
+string StringBuilder::build() const {
+    string result;
+    buildInto(result);
+    return result;
+}
+
+/*
+ * Function: StringBuilder::buildInto
+ * Purpose: Writes the joined text into 'out', reusing its buffer when it
+ * is already big enough (then nothing is allocated at all)
+ */
+void StringBuilder::buildInto(string& out) const {
+    out.resize(total);
+    char* at = &out[0];
+    for (string_view piece : pieces) {
+        memcpy(at, piece.data(), piece.size());
+        at += piece.size();
+    }
+}
+
+// name() from strngs.cpp, built without modifying fname
+string name() {
+    string fname = "\"Pravin\"";
+    string lname = "\"Haligonda\"";
+    return StringBuilder(2).append(fname).append(lname).build();
+}
+
+// modifyStr() from functions.cpp: appends "world" with a single allocation
+void modifyStr(string &s) {
+    StringBuilder b(2);
+    b << s << "world";
+    s = b.build();
+}
+
+// The kind of report line our services produce millions of times
+const string_view FIELDS[] = {"ts=", "2025-06-01T12:00:00Z", " level=", "INFO",
+                              " car=", "Range Rover", " model=", "Sport",
+                              " year=", "2025", " msg=", "inventory updated for dealer",
+                              " region=", "north-east", " status=", "ok"};
+const size_t FIELD_COUNT = sizeof(FIELDS) / sizeof(FIELDS[0]);
+
+string naiveAppend() {
+    string line;
+    for (string_view field : FIELDS) {
+        line += field;
+    }
+    return line;
+}
+
+string naivePlus() {
+    string line = string(FIELDS[0]) + string(FIELDS[1]) + string(FIELDS[2]) + string(FIELDS[3]) +
+                  string(FIELDS[4]) + string(FIELDS[5]) + string(FIELDS[6]) + string(FIELDS[7]) +
+                  string(FIELDS[8]) + string(FIELDS[9]) + string(FIELDS[10]) + string(FIELDS[11]) +
+                  string(FIELDS[12]) + string(FIELDS[13]) + string(FIELDS[14]) + string(FIELDS[15]);
+    return line;
+}
+
+string withBuilder(StringBuilder& b) {
+    b.clear();
+    for (string_view field : FIELDS) {
+        b.append(field);
+    }
+    return b.build();
+}
+
+/*
+ * Function: measure
+ * Purpose: Runs 'build' many times and prints time and allocations per line
+ */
+template <typename Build>
+void measure(const char* label, size_t builds, Build build) {
+    size_t checksum = 0;
+    size_t before = allocations.load();
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < builds; i++) {
+        checksum += build().size();
+    }
+    double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+    size_t allocs = allocations.load() - before;
+    cout << "  " << label << (double)allocs / builds << " allocs/line, "
+         << ns / builds << " ns/line (" << checksum / builds << " chars)" << endl;
+}
+
+int main(int argc, char* argv[]) {
+
+    cout << name() << endl;
+
+    string greet = "hello, ";
+    modifyStr(greet);
+    cout << greet << endl << endl;
+
+    size_t builds = 1000000;
+    if (argc > 1) {
+        builds = strtoul(argv[1], nullptr, 10);
+    }
+
+    cout << "Building a " << FIELD_COUNT << "-piece report line " << builds << " times:" << endl;
+    measure("s += piece:        ", builds, naiveAppend);
+    measure("a + b + c + ...:   ", builds, naivePlus);
+    StringBuilder builder(FIELD_COUNT);
+    measure("StringBuilder:     ", builds, [&builder] { return withBuilder(builder); });
+
+    string reused;
+    measure("buildInto (reuse): ", builds, [&builder, &reused]() -> const string& {
+        builder.clear();
+        for (string_view field : FIELDS) {
+            builder.append(field);
+        }
+        builder.buildInto(reused);
+        return reused;
+    });
+
+    /*
+     * Key Learning Points:
+     * 1. Repeated += reallocates and copies each time capacity runs out
+     * 2. a + b + c creates temporary strings for the partial results
+     * 3. Summing the lengths first allows a single exact-size allocation
+     * 4. string_view refers to text without owning or copying it
+     * 5. Replacing operator new is a simple way to count allocations
+     */
+
+    return 0;
+}
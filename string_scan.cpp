@@ -0,0 +1,441 @@
+/*
+ * C++ Vectorised String Scanning Examples
+ * =======================================
+ *
+ * This file goes beyond length()/size() from strngs.cpp with a small
+ * library of text-scanning kernels:
+ * - findByte       like s.find(c)
+ * - findAnyOf      like s.find_first_of(set)
+ * - countByte      like std::count(s.begin(), s.end(), c)
+ * - equalsNoCase   ASCII case-insensitive comparison
+ * - startsWith     like s.compare(0, p.size(), p) == 0
+ *
+ * Each kernel has a portable scalar version plus SSE4.2 (16 bytes at a
+ * time) and AVX2 (32 bytes at a time) versions. At startup the program
+ * asks the CPU (CPUID) what it supports and fills a table of function
+ * pointers with the best versions, so one binary runs everywhere.
+ * A fuzz test checks every version against the std::string equivalent.
+ *
+ * Usage: ./scan [megabytes]   (default: 64, at least 1)
+ */
+
+#include <algorithm>    // For std::count (fuzz reference)
+#include <chrono>       // For timing the benchmark
+#include <cstdlib>      // For strtoul
+#include <iostream>     // For input/output operations
+#include <random>       // For fuzz and benchmark data
+#include <string>       // For string class
+#include <vector>       // For the list of implementations
+#include <immintrin.h>  // For SSE/AVX2 intrinsics
+using namespace std;
+
+const size_t NOT_FOUND = (size_t)-1;
+
+/*
+ * Struct: ScanKernels
+ * Purpose: One complete set of kernels for a given instruction set
+ */
+struct ScanKernels {
+    const char* name;
+    size_t (*findByte)(const char* s, size_t n, char c);
+    size_t (*findAnyOf)(const char* s, size_t n, const char* set, size_t setLen);
+    size_t (*countByte)(const char* s, size_t n, char c);
+    bool (*equalsNoCase)(const char* a, const char* b, size_t n);
+    bool (*startsWith)(const char* s, size_t n, const char* prefix, size_t m);
+};
+
+// ---------------------------------------------------------------------
+// Scalar versions: one byte per step, work on any CPU
+// ---------------------------------------------------------------------
+
+char lowerAscii(char c) {
+    return (c >= 'A' && c <= 'Z') ? (char)(c + 32) : c;
+}
+
+size_t findByteScalar(const char* s, size_t n, char c) {
+    for (size_t i = 0; i < n; i++) {
+        if (s[i] == c) {
+            return i;
+        }
+    }
+    return NOT_FOUND;
+}
+
+size_t findAnyOfScalar(const char* s, size_t n, const char* set, size_t setLen) {
+    bool member[256] = {false};
+    for (size_t k = 0; k < setLen; k++) {
+        member[(unsigned char)set[k]] = true;
+    }
+    for (size_t i = 0; i < n; i++) {
+        if (member[(unsigned char)s[i]]) {
+            return i;
+        }
+    }
+    return NOT_FOUND;
+}
+
+size_t countByteScalar(const char* s, size_t n, char c) {
+    size_t count = 0;
+    for (size_t i = 0; i < n; i++) {
+        count += s[i] == c;
+    }
+    return count;
+}
+
+bool equalsNoCaseScalar(const char* a, const char* b, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        if (lowerAscii(a[i]) != lowerAscii(b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool startsWithScalar(const char* s, size_t n, const char* prefix, size_t m) {
+    if (m > n) {
+        return false;
+    }
+    for (size_t i = 0; i < m; i++) {
+        if (s[i] != prefix[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------
+// SSE4.2 versions: 16 bytes per step. Each loop handles whole blocks and
+// hands the last few bytes to the scalar version, so nothing is ever
+// read past the end of the buffer.
+// ---------------------------------------------------------------------
+
+#define SSE42 __attribute__((target("sse4.2,popcnt")))
+
+SSE42 size_t findByteSSE42(const char* s, size_t n, char c) {
+    const __m128i needle = _mm_set1_epi8(c);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i*)(s + i));
+        int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(block, needle));
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    size_t rest = findByteScalar(s + i, n - i, c);
+    return rest == NOT_FOUND ? NOT_FOUND : i + rest;
+}
+
+// pcmpestri compares each byte of the block with up to 16 set characters
+SSE42 size_t findAnyOfSSE42(const char* s, size_t n, const char* set, size_t setLen) {
+    if (setLen == 0 || setLen > 16) {
+        return findAnyOfScalar(s, n, set, setLen);
+    }
+    char padded[16] = {0};
+    for (size_t k = 0; k < setLen; k++) {
+        padded[k] = set[k];
+    }
+    const __m128i chars = _mm_loadu_si128((const __m128i*)padded);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i*)(s + i));
+        int at = _mm_cmpestri(chars, (int)setLen, block, 16,
+                              _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_LEAST_SIGNIFICANT);
+        if (at < 16) {
+            return i + at;
+        }
+    }
+    size_t rest = findAnyOfScalar(s + i, n - i, set, setLen);
+    return rest == NOT_FOUND ? NOT_FOUND : i + rest;
+}
+
+SSE42 size_t countByteSSE42(const char* s, size_t n, char c) {
+    const __m128i needle = _mm_set1_epi8(c);
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i*)(s + i));
+        count += __builtin_popcount(_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle)));
+    }
+    return count + countByteScalar(s + i, n - i, c);
+}
+
+// Adds 32 to bytes in 'A'..'Z'. Bytes >= 0x80 are negative as signed
+// chars, so the signed range test leaves them untouched.
+SSE42 __m128i lowerSSE42(__m128i v) {
+    __m128i isUpper = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('A' - 1)),
+                                    _mm_cmpgt_epi8(_mm_set1_epi8('Z' + 1), v));
+    return _mm_add_epi8(v, _mm_and_si128(isUpper, _mm_set1_epi8(32)));
+}
+
+SSE42 bool equalsNoCaseSSE42(const char* a, const char* b, size_t n) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i x = lowerSSE42(_mm_loadu_si128((const __m128i*)(a + i)));
+        __m128i y = lowerSSE42(_mm_loadu_si128((const __m128i*)(b + i)));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) != 0xFFFF) {
+            return false;
+        }
+    }
+    return equalsNoCaseScalar(a + i, b + i, n - i);
+}
+
+SSE42 bool startsWithSSE42(const char* s, size_t n, const char* prefix, size_t m) {
+    if (m > n) {
+        return false;
+    }
+    size_t i = 0;
+    for (; i + 16 <= m; i += 16) {
+        __m128i x = _mm_loadu_si128((const __m128i*)(s + i));
+        __m128i y = _mm_loadu_si128((const __m128i*)(prefix + i));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) != 0xFFFF) {
+            return false;
+        }
+    }
+    return startsWithScalar(s + i, m - i, prefix + i, m - i);
+}
+
+// ---------------------------------------------------------------------
+// AVX2 versions: 32 bytes per step, same structure as SSE4.2
+// ---------------------------------------------------------------------
+
+#define AVX2 __attribute__((target("avx2,popcnt")))
+
+AVX2 size_t findByteAVX2(const char* s, size_t n, char c) {
+    const __m256i needle = _mm256_set1_epi8(c);
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i*)(s + i));
+        unsigned mask = (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, needle));
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    size_t rest = findByteScalar(s + i, n - i, c);
+    return rest == NOT_FOUND ? NOT_FOUND : i + rest;
+}
+
+// AVX2 has no pcmpestri, so compare against each set character and OR
+AVX2 size_t findAnyOfAVX2(const char* s, size_t n, const char* set, size_t setLen) {
+    if (setLen == 0 || setLen > 16) {
+        return findAnyOfScalar(s, n, set, setLen);
+    }
+    __m256i chars[16];
+    for (size_t k = 0; k < setLen; k++) {
+        chars[k] = _mm256_set1_epi8(set[k]);
+    }
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i*)(s + i));
+        __m256i hit = _mm256_setzero_si256();
+        for (size_t k = 0; k < setLen; k++) {
+            hit = _mm256_or_si256(hit, _mm256_cmpeq_epi8(block, chars[k]));
+        }
+        unsigned mask = (unsigned)_mm256_movemask_epi8(hit);
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    size_t rest = findAnyOfScalar(s + i, n - i, set, setLen);
+    return rest == NOT_FOUND ? NOT_FOUND : i + rest;
+}
+
+AVX2 size_t countByteAVX2(const char* s, size_t n, char c) {
+    const __m256i needle = _mm256_set1_epi8(c);
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i*)(s + i));
+        count += __builtin_popcount((unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, needle)));
+    }
+    return count + countByteScalar(s + i, n - i, c);
+}
+
+AVX2 __m256i lowerAVX2(__m256i v) {
+    __m256i isUpper = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('A' - 1)),
+                                       _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), v));
+    return _mm256_add_epi8(v, _mm256_and_si256(isUpper, _mm256_set1_epi8(32)));
+}
+
+AVX2 bool equalsNoCaseAVX2(const char* a, const char* b, size_t n) {
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i x = lowerAVX2(_mm256_loadu_si256((const __m256i*)(a + i)));
+        __m256i y = lowerAVX2(_mm256_loadu_si256((const __m256i*)(b + i)));
+        if ((unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)) != 0xFFFFFFFFu) {
+            return false;
+        }
+    }
+    return equalsNoCaseScalar(a + i, b + i, n - i);
+}
+
+AVX2 bool startsWithAVX2(const char* s, size_t n, const char* prefix, size_t m) {
+    if (m > n) {
+        return false;
+    }
+    size_t i = 0;
+    for (; i + 32 <= m; i += 32) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)(s + i));
+        __m256i y = _mm256_loadu_si256((const __m256i*)(prefix + i));
+        if ((unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)) != 0xFFFFFFFFu) {
+            return false;
+        }
+    }
+    return startsWithScalar(s + i, m - i, prefix + i, m - i);
+}
+
+// ---------------------------------------------------------------------
+// Runtime dispatch
+// ---------------------------------------------------------------------
+
+const ScanKernels SCALAR_KERNELS = {"scalar", findByteScalar, findAnyOfScalar,
+                                    countByteScalar, equalsNoCaseScalar, startsWithScalar};
+const ScanKernels SSE42_KERNELS = {"SSE4.2", findByteSSE42, findAnyOfSSE42,
+                                   countByteSSE42, equalsNoCaseSSE42, startsWithSSE42};
+const ScanKernels AVX2_KERNELS = {"AVX2", findByteAVX2, findAnyOfAVX2,
+                                  countByteAVX2, equalsNoCaseAVX2, startsWithAVX2};
+
+// Every kernel set this CPU can run, slowest first
+vector<const ScanKernels*> supportedKernels() {
+    __builtin_cpu_init();
+    vector<const ScanKernels*> sets;
+    sets.push_back(&SCALAR_KERNELS);
+    if (__builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt")) {
+        sets.push_back(&SSE42_KERNELS);
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) {
+        sets.push_back(&AVX2_KERNELS);
+    }
+    return sets;
+}
+
+// The kernels everyone should call: chosen once, before main() runs
+const ScanKernels& scan = *supportedKernels().back();
+
+// ---------------------------------------------------------------------
+// Fuzz test and benchmark
+// ---------------------------------------------------------------------
+
+string randomText(mt19937& rng, size_t n, const string& alphabet) {
+    string s(n, ' ');
+    for (char& c : s) {
+        c = alphabet[rng() % alphabet.size()];
+    }
+    return s;
+}
+
+/*
+ * Function: fuzz
+ * Purpose: Compares one kernel set against std::string on random inputs
+ * A small alphabet (including upper case and a non-ASCII byte) makes
+ * matches, near-matches and case differences common.
+ */
+bool fuzz(const ScanKernels& k, int rounds) {
+    mt19937 rng(2024);
+    const string alphabet = "abcAB,;\xe9";
+    for (int r = 0; r < rounds; r++) {
+        string s = randomText(rng, rng() % 200, alphabet);
+        string t = randomText(rng, rng() % 20, alphabet);
+        if (rng() % 3 == 0) {
+            t = s.substr(0, rng() % (s.size() + 1));  // A real prefix
+        }
+        char c = alphabet[rng() % alphabet.size()];
+        size_t n = s.size();
+
+        size_t expectFind = s.find(c);
+        size_t expectAny = s.find_first_of(t);
+        size_t expectCount = (size_t)count(s.begin(), s.end(), c);
+        bool expectPrefix = s.compare(0, t.size(), t) == 0 && t.size() <= n;
+
+        string u = s;
+        for (char& ch : u) {
+            if (rng() % 2) ch = (ch >= 'a' && ch <= 'z') ? (char)(ch - 32) : ch;
+        }
+        if (rng() % 4 == 0 && n > 0) {
+            u[rng() % n] = ';';
+        }
+        string lowerS = s, lowerU = u;
+        for (char& ch : lowerS) ch = lowerAscii(ch);
+        for (char& ch : lowerU) ch = lowerAscii(ch);
+        bool expectNoCase = lowerS == lowerU;
+
+        if (k.findByte(s.data(), n, c) != (expectFind == string::npos ? NOT_FOUND : expectFind) ||
+            k.findAnyOf(s.data(), n, t.data(), t.size()) != (expectAny == string::npos ? NOT_FOUND : expectAny) ||
+            k.countByte(s.data(), n, c) != expectCount ||
+            k.startsWith(s.data(), n, t.data(), t.size()) != expectPrefix ||
+            k.equalsNoCase(s.data(), u.data(), n) != expectNoCase) {
+            cout << "  " << k.name << " mismatch on input \"" << s << "\"" << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename Work>
+double bestGBs(size_t bytes, Work work) {
+    double best = 1e30;
+    for (int r = 0; r < 5; r++) {
+        auto start = chrono::steady_clock::now();
+        work();
+        best = min(best, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+    }
+    return bytes / best / 1e9;
+}
+
+void benchmark(size_t megabytes, const vector<const ScanKernels*>& sets) {
+    mt19937 rng(9);
+    size_t n = megabytes << 20;
+    string text = randomText(rng, n, "abcdefghijklmnopqrstuvwxyz ");
+    text[n - 1] = '!';  // The only match for find: a worst-case full scan
+    string upper = text;
+    for (char& c : upper) c = (char)toupper((unsigned char)c);
+
+    cout << "Throughput over " << megabytes << " MB (GB/s)" << endl;
+    cout << "  kernel\tfind\tfindAny\tcount\tnoCase\tprefix" << endl;
+    volatile size_t sink = 0;
+    for (const ScanKernels* k : sets) {
+        cout << "  " << k->name << "\t"
+             << bestGBs(n, [&] { sink = k->findByte(text.data(), n, '!'); }) << "\t"
+             << bestGBs(n, [&] { sink = k->findAnyOf(text.data(), n, "!?#", 3); }) << "\t"
+             << bestGBs(n, [&] { sink = k->countByte(text.data(), n, 'e'); }) << "\t"
+             << bestGBs(n, [&] { sink = k->equalsNoCase(text.data(), upper.data(), n); }) << "\t"
+             << bestGBs(n, [&] { sink = k->startsWith(text.data(), n, text.data(), n); }) << endl;
+    }
+    (void)sink;
+}
+
+int main(int argc, char* argv[]) {
+    cout << "Best kernels on this CPU: " << scan.name << endl;
+
+    string txt = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    cout << "Length: " << txt.length() << endl;
+    cout << "Position of 'K': " << scan.findByte(txt.data(), txt.size(), 'K') << endl;
+    cout << "First vowel at: " << scan.findAnyOf(txt.data(), txt.size(), "AEIOU", 5) << endl;
+    cout << "Starts with \"ABC\": " << scan.startsWith(txt.data(), txt.size(), "ABC", 3) << endl;
+    cout << "Equals lower-case alphabet (ignoring case): "
+         << scan.equalsNoCase(txt.data(), "abcdefghijklmnopqrstuvwxyz", txt.size()) << endl << endl;
+
+    vector<const ScanKernels*> sets = supportedKernels();
+    cout << "Fuzz test against std::string:" << endl;
+    for (const ScanKernels* k : sets) {
+        cout << "  " << k->name << ": " << (fuzz(*k, 200000) ? "passed" : "FAILED") << endl;
+    }
+    cout << endl;
+
+    size_t megabytes = 64;
+    if (argc > 1) {
+        megabytes = max<size_t>(strtoul(argv[1], nullptr, 10), 1);  // The text needs room for its '!'
+    }
+    benchmark(megabytes, sets);
+
+    /*
+     * Key Learning Points:
+     * 1. SIMD compares 16 or 32 bytes with one instruction, then movemask
+     *    turns the result into a bit mask we can test or count
+     * 2. __builtin_ctz finds the first set bit: the position of the match
+     * 3. Handling the tail with scalar code avoids reading past the end
+     * 4. A table of function pointers filled once gives runtime dispatch
+     * 5. Fuzzing against a simple reference catches off-by-one mistakes
+     */
+
+    return 0;
+}
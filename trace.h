@@ -0,0 +1,367 @@
+/*
+ * C++ Hot-Path Tracing
+ * ====================
+ *
+ * microbench.h measures a function in isolation; this header measures
+ * it where it runs, inside the program. It provides:
+ * - TRACE_SCOPE("name"): a scoped timer that reads the CPU's time-stamp
+ *   counter (TSC) when the scope starts and ends
+ * - Per-thread log-linear latency histograms per probe, updated without
+ *   locks or locked instructions
+ * - dumpTracePercentiles(): count, p50, p90, p99, p99.9 and max per probe
+ * - writeChromeTrace(): the recent scopes of every thread as Chrome
+ *   trace-event JSON (open in chrome://tracing or ui.perfetto.dev)
+ * - On-demand dumps: SIGUSR1 sets a flag that traceDumpIfRequested()
+ *   checks at a safe point
+ *
+ * Concept: rdtsc costs about 20 cycles, far less than a clock_gettime()
+ * call, and a histogram bucket is found with one count-leading-zeros
+ * instruction: 8 buckets per power of two keep every reading within
+ * 12.5%. Each thread owns its histograms, so recording is a plain load
+ * and store. Probes are compiled in only with -DTRACE_ENABLED=1;
+ * otherwise TRACE_SCOPE expands to nothing and costs nothing.
+ *
+ * Notes: the TSC ticks at a constant rate on current x86 CPUs and is
+ * converted to nanoseconds by comparing it with steady_clock. Dumps read
+ * other threads' data while they may still be writing it: counts are
+ * exact, but a trace event being written at that moment may be garbled,
+ * so dump from a quiet point (e.g. after joining workers) when possible.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <algorithm>    // For min/max
+#include <atomic>       // For shared counters and the thread list
+#include <chrono>       // For calibrating the TSC
+#include <csignal>      // For SIGUSR1
+#include <cstdint>      // For uint64_t
+#include <cstdlib>      // For calloc
+#include <fstream>      // For the Chrome trace file
+#include <iomanip>      // For the percentile table
+#include <iostream>     // For dumps
+#include <string>       // For paths
+#include <thread>       // For sleep_for
+#include <vector>       // For merged results
+#include <x86intrin.h>  // For __rdtsc
+
+#ifndef TRACE_ENABLED
+#define TRACE_ENABLED 0
+#endif
+
+const uint32_t MAX_TRACE_SITES = 64;
+const uint32_t TRACE_SUB_BUCKETS = 8;    // Buckets per power of two
+const uint32_t TRACE_BUCKETS = 62 * TRACE_SUB_BUCKETS;
+const size_t TRACE_EVENTS_PER_THREAD = 1 << 16;  // Ring buffer of recent scopes
+
+/*
+ * Struct: TraceHistogram
+ * Purpose: Durations of one probe on one thread, in TSC ticks
+ * Bucket b < 8 holds exactly b ticks; above that, bucket 8 * (g - 2) + s
+ * holds [(8 + s) << (g - 3), (9 + s) << (g - 3)), g = floor(log2(ticks)).
+ */
+struct TraceHistogram {
+    std::atomic<uint64_t> counts[TRACE_BUCKETS];
+    std::atomic<uint64_t> maxTicks;
+};
+
+struct TraceEvent {
+    uint64_t start;     // TSC at scope entry
+    uint64_t ticks;     // Duration
+    uint32_t site;
+};
+
+/*
+ * Struct: ThreadTrace
+ * Purpose: Everything one thread records, written only by that thread
+ * Blocks are never freed, so threads that have exited are still dumped.
+ */
+struct ThreadTrace {
+    std::atomic<TraceHistogram*> sites[MAX_TRACE_SITES];  // Allocated on first use
+    std::atomic<TraceEvent*> events;                       // Ring buffer, if events are on
+    std::atomic<uint64_t> eventCount;                      // Events ever written
+    uint32_t id;
+    ThreadTrace* nextThread;
+};
+
+inline const char* traceSiteNames[MAX_TRACE_SITES];
+inline std::atomic<uint32_t> traceSiteCount(0);
+inline std::atomic<ThreadTrace*> allTraceThreads(nullptr);
+inline std::atomic<uint32_t> traceThreadCount(0);
+inline thread_local ThreadTrace* myTrace = nullptr;
+inline std::atomic<bool> traceEventsEnabled(false);
+inline volatile std::sig_atomic_t traceDumpRequested = 0;
+
+// TSC and steady_clock readings taken at startup, for converting ticks
+inline const uint64_t TRACE_START_TICKS = __rdtsc();
+inline const std::chrono::steady_clock::time_point TRACE_START_TIME = std::chrono::steady_clock::now();
+
+inline void traceBump(std::atomic<uint64_t>& counter, uint64_t amount) {
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+/*
+ * Function: registerTraceSite
+ * Purpose: Gives a probe name its index; called once per TRACE_SCOPE
+ * (through a function-local static). Returns MAX_TRACE_SITES, which
+ * recordTrace() ignores, once the table is full.
+ */
+inline uint32_t registerTraceSite(const char* name) {
+    uint32_t site = traceSiteCount.load();
+    while (site < MAX_TRACE_SITES && !traceSiteCount.compare_exchange_weak(site, site + 1)) {
+    }
+    if (site >= MAX_TRACE_SITES) {
+        return MAX_TRACE_SITES;
+    }
+    traceSiteNames[site] = name;
+    return site;
+}
+
+// Records Chrome trace events from now on (histograms are always kept)
+inline void setTraceEvents(bool on) {
+    traceEventsEnabled.store(on);
+}
+
+inline ThreadTrace& threadTrace() {
+    if (myTrace == nullptr) {
+        ThreadTrace* trace = (ThreadTrace*)std::calloc(1, sizeof(ThreadTrace));
+        trace->id = traceThreadCount.fetch_add(1) + 1;
+        trace->nextThread = allTraceThreads.load();
+        while (!allTraceThreads.compare_exchange_weak(trace->nextThread, trace)) {
+        }
+        myTrace = trace;
+    }
+    return *myTrace;
+}
+
+inline uint32_t traceBucketOf(uint64_t ticks) {
+    if (ticks < TRACE_SUB_BUCKETS) {
+        return (uint32_t)ticks;
+    }
+    uint32_t g = 63 - __builtin_clzll(ticks);
+    uint32_t sub = (uint32_t)(ticks >> (g - 3)) & (TRACE_SUB_BUCKETS - 1);
+    return (g - 2) * TRACE_SUB_BUCKETS + sub;
+}
+
+// Smallest tick count in bucket b
+inline uint64_t traceBucketLow(uint32_t b) {
+    if (b < TRACE_SUB_BUCKETS) {
+        return b;
+    }
+    uint32_t g = b / TRACE_SUB_BUCKETS + 2;
+    return (uint64_t)(TRACE_SUB_BUCKETS + b % TRACE_SUB_BUCKETS) << (g - 3);
+}
+
+/*
+ * Function: recordTrace
+ * Purpose: Adds one scope of 'ticks' that started at 'start' to this
+ * thread's histogram for 'site' and, if enabled, to its event ring
+ */
+inline void recordTrace(uint32_t site, uint64_t start, uint64_t ticks) {
+    if (site >= MAX_TRACE_SITES) {
+        return;
+    }
+    ThreadTrace& trace = threadTrace();
+    TraceHistogram* histogram = trace.sites[site].load(std::memory_order_relaxed);
+    if (histogram == nullptr) {
+        histogram = (TraceHistogram*)std::calloc(1, sizeof(TraceHistogram));
+        trace.sites[site].store(histogram, std::memory_order_release);
+    }
+    traceBump(histogram->counts[traceBucketOf(ticks)], 1);
+    if (ticks > histogram->maxTicks.load(std::memory_order_relaxed)) {
+        histogram->maxTicks.store(ticks, std::memory_order_relaxed);
+    }
+    if (traceEventsEnabled.load(std::memory_order_relaxed)) {
+        TraceEvent* events = trace.events.load(std::memory_order_relaxed);
+        if (events == nullptr) {
+            events = (TraceEvent*)std::calloc(TRACE_EVENTS_PER_THREAD, sizeof(TraceEvent));
+            trace.events.store(events, std::memory_order_release);
+        }
+        uint64_t n = trace.eventCount.load(std::memory_order_relaxed);
+        events[n % TRACE_EVENTS_PER_THREAD] = {start, ticks, site};
+        trace.eventCount.store(n + 1, std::memory_order_release);
+    }
+}
+
+/*
+ * Class: ScopedTrace
+ * Purpose: Times its own lifetime and records it for one probe site
+ */
+class ScopedTrace {
+    private:
+        uint32_t site;
+        uint64_t start;
+
+    public:
+        explicit ScopedTrace(uint32_t traceSite) : site(traceSite), start(__rdtsc()) {}
+        ~ScopedTrace() { recordTrace(site, start, __rdtsc() - start); }
+
+        ScopedTrace(const ScopedTrace&) = delete;
+        ScopedTrace& operator=(const ScopedTrace&) = delete;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#if TRACE_ENABLED
+#define TRACE_SCOPE(name)                                                                \
+    static const uint32_t TRACE_CONCAT(traceSite, __LINE__) = registerTraceSite(name);   \
+    ScopedTrace TRACE_CONCAT(traceScope, __LINE__)(TRACE_CONCAT(traceSite, __LINE__))
+#else
+#define TRACE_SCOPE(name) static_assert(true, "")
+#endif
+
+/*
+ * Function: traceTicksPerNs
+ * Purpose: TSC rate, measured against steady_clock since startup
+ * The longer the program has run, the more precise the rate.
+ */
+inline double traceTicksPerNs() {
+    auto elapsed = std::chrono::steady_clock::now() - TRACE_START_TIME;
+    if (elapsed < std::chrono::milliseconds(10)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10) - elapsed);
+    }
+    uint64_t ticks = __rdtsc() - TRACE_START_TICKS;
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - TRACE_START_TIME).count();
+    return ticks / ns;
+}
+
+/*
+ * Struct: TraceSummary
+ * Purpose: One probe's histograms merged over all threads
+ */
+struct TraceSummary {
+    const char* name;
+    uint64_t counts[TRACE_BUCKETS];
+    uint64_t total;
+    uint64_t maxTicks;
+
+    // Tick count at quantile q: midpoint of the bucket holding it
+    double quantileTicks(double q) const {
+        uint64_t rank = (uint64_t)(q * (total - 1)) + 1, seen = 0;
+        for (uint32_t b = 0; b < TRACE_BUCKETS; b++) {
+            seen += counts[b];
+            if (seen >= rank) {
+                double low = (double)traceBucketLow(b);
+                double high = b + 1 < TRACE_BUCKETS ? (double)traceBucketLow(b + 1) : low;
+                return std::min((low + high) / 2, (double)maxTicks);
+            }
+        }
+        return (double)maxTicks;
+    }
+};
+
+inline std::vector<TraceSummary> mergeTraces() {
+    uint32_t sites = std::min(traceSiteCount.load(), MAX_TRACE_SITES);
+    std::vector<TraceSummary> summaries(sites);
+    for (uint32_t s = 0; s < sites; s++) {
+        summaries[s] = TraceSummary{traceSiteNames[s], {}, 0, 0};
+    }
+    for (ThreadTrace* t = allTraceThreads.load(); t != nullptr; t = t->nextThread) {
+        for (uint32_t s = 0; s < sites; s++) {
+            TraceHistogram* h = t->sites[s].load(std::memory_order_acquire);
+            if (h == nullptr) {
+                continue;
+            }
+            for (uint32_t b = 0; b < TRACE_BUCKETS; b++) {
+                uint64_t c = h->counts[b].load(std::memory_order_relaxed);
+                summaries[s].counts[b] += c;
+                summaries[s].total += c;
+            }
+            summaries[s].maxTicks = std::max(summaries[s].maxTicks, h->maxTicks.load(std::memory_order_relaxed));
+        }
+    }
+    return summaries;
+}
+
+/*
+ * Function: dumpTracePercentiles
+ * Purpose: Prints a latency table (nanoseconds) for every probe that ran
+ */
+inline void dumpTracePercentiles(std::ostream& out) {
+    double perNs = traceTicksPerNs();
+    bool any = false;
+    for (const TraceSummary& s : mergeTraces()) {
+        if (s.total == 0) {
+            continue;
+        }
+        if (!any) {
+            out << "  probe                         count      p50 ns     p90 ns     p99 ns   p99.9 ns     max ns"
+                << std::endl;
+            any = true;
+        }
+        out << "  " << std::left << std::setw(24) << s.name << std::right << std::setw(12) << s.total << std::fixed
+            << std::setprecision(1);
+        for (double q : {0.5, 0.9, 0.99, 0.999}) {
+            out << std::setw(11) << s.quantileTicks(q) / perNs;
+        }
+        out << std::setw(11) << s.maxTicks / perNs << std::defaultfloat << std::setprecision(6) << std::endl;
+    }
+    if (!any) {
+        out << "  (no probes recorded)" << std::endl;
+    }
+}
+
+/*
+ * Function: writeChromeTrace
+ * Purpose: Writes the events still in every thread's ring buffer as
+ * complete ("ph": "X") trace events; returns false if the file fails
+ */
+inline bool writeChromeTrace(const std::string& path) {
+    std::ofstream out(path);
+    if (!out) {
+        return false;
+    }
+    double perUs = traceTicksPerNs() * 1000;
+    out << "{\"traceEvents\": [\n";
+    bool first = true;
+    for (ThreadTrace* t = allTraceThreads.load(); t != nullptr; t = t->nextThread) {
+        uint64_t n = t->eventCount.load(std::memory_order_acquire);
+        const TraceEvent* events = t->events.load(std::memory_order_acquire);
+        if (events == nullptr) {
+            continue;
+        }
+        for (uint64_t i = n > TRACE_EVENTS_PER_THREAD ? n - TRACE_EVENTS_PER_THREAD : 0; i < n; i++) {
+            const TraceEvent& e = events[i % TRACE_EVENTS_PER_THREAD];
+            if (e.site >= MAX_TRACE_SITES || e.start < TRACE_START_TICKS) {
+                continue;  // Being overwritten while we read
+            }
+            out << (first ? "" : ",\n") << "{\"name\": \"" << traceSiteNames[e.site]
+                << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << t->id << std::fixed << std::setprecision(3)
+                << ", \"ts\": " << (e.start - TRACE_START_TICKS) / perUs << ", \"dur\": " << e.ticks / perUs << "}"
+                << std::defaultfloat;
+            first = false;
+        }
+    }
+    out << "\n]}\n";
+    return (bool)out;
+}
+
+// Signal handlers may only set a flag; the dump happens at a safe point
+inline void traceSignalHandler(int) {
+    traceDumpRequested = 1;
+}
+
+// Makes "kill -USR1 <pid>" request a dump
+inline void installTraceDumpSignal() {
+    std::signal(SIGUSR1, traceSignalHandler);
+}
+
+/*
+ * Function: traceDumpIfRequested
+ * Purpose: Dumps percentiles (and the trace file, if a path is given)
+ * when SIGUSR1 has arrived since the last call; returns whether it did
+ */
+inline bool traceDumpIfRequested(std::ostream& out, const std::string& tracePath = "") {
+    if (!traceDumpRequested) {
+        return false;
+    }
+    traceDumpRequested = 0;
+    dumpTracePercentiles(out);
+    if (!tracePath.empty() && !writeChromeTrace(tracePath)) {
+        out << "Cannot write " << tracePath << std::endl;
+    }
+    return true;
+}
+
+#endif